@@ -0,0 +1,691 @@
+// algorithm_kernels.h: 31 render kernels and carrier masks, generated by generate_luts from the algorithm routing table
+
+static int32_t render_algorithm_0(voice_data_t *p_voice_data, uint8_t feedback_shift, uint32_t voice_start, uint32_t voice_end) {
+	int32_t master_buffer = 0;
+
+	operator_clear_input(p_voice_data, 0, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 1, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 2, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 3, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 4, voice_start, voice_end);
+	operator_feedback_input(p_voice_data, 5, feedback_shift, voice_start, voice_end);
+
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 5, OUTPUT_MODE_INDEX_5, false, true);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 4, OUTPUT_MODE_INDEX_4, false, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 3, OUTPUT_MODE_INDEX_3, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 2, 0, true, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 1, OUTPUT_MODE_INDEX_1, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 0, 0, true, false);
+
+	return master_buffer;
+}
+
+static int32_t render_algorithm_1(voice_data_t *p_voice_data, uint8_t feedback_shift, uint32_t voice_start, uint32_t voice_end) {
+	int32_t master_buffer = 0;
+
+	operator_clear_input(p_voice_data, 0, voice_start, voice_end);
+	operator_feedback_input(p_voice_data, 1, feedback_shift, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 2, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 3, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 4, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 5, voice_start, voice_end);
+
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 5, OUTPUT_MODE_INDEX_5, false, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 4, OUTPUT_MODE_INDEX_4, false, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 3, OUTPUT_MODE_INDEX_3, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 2, 0, true, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 1, OUTPUT_MODE_INDEX_1, false, true);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 0, 0, true, false);
+
+	return master_buffer;
+}
+
+static int32_t render_algorithm_2(voice_data_t *p_voice_data, uint8_t feedback_shift, uint32_t voice_start, uint32_t voice_end) {
+	int32_t master_buffer = 0;
+
+	operator_clear_input(p_voice_data, 0, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 1, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 2, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 3, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 4, voice_start, voice_end);
+	operator_feedback_input(p_voice_data, 5, feedback_shift, voice_start, voice_end);
+
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 5, OUTPUT_MODE_INDEX_5, false, true);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 4, OUTPUT_MODE_INDEX_4, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 3, 0, true, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 2, OUTPUT_MODE_INDEX_2, false, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 1, OUTPUT_MODE_INDEX_1, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 0, 0, true, false);
+
+	return master_buffer;
+}
+
+static int32_t render_algorithm_3(voice_data_t *p_voice_data, uint8_t feedback_shift, uint32_t voice_start, uint32_t voice_end) {
+	int32_t master_buffer = 0;
+	(void) feedback_shift;
+
+	operator_clear_input(p_voice_data, 0, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 1, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 2, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 3, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 4, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 5, voice_start, voice_end);
+
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 5, OUTPUT_MODE_INDEX_5, false, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 4, OUTPUT_MODE_INDEX_4, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 3, 0, true, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 2, OUTPUT_MODE_INDEX_2, false, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 1, OUTPUT_MODE_INDEX_1, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 0, 0, true, false);
+
+	return master_buffer;
+}
+
+static int32_t render_algorithm_4(voice_data_t *p_voice_data, uint8_t feedback_shift, uint32_t voice_start, uint32_t voice_end) {
+	int32_t master_buffer = 0;
+
+	operator_clear_input(p_voice_data, 0, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 1, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 2, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 3, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 4, voice_start, voice_end);
+	operator_feedback_input(p_voice_data, 5, feedback_shift, voice_start, voice_end);
+
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 5, OUTPUT_MODE_INDEX_5, false, true);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 4, 0, true, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 3, OUTPUT_MODE_INDEX_3, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 2, 0, true, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 1, OUTPUT_MODE_INDEX_1, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 0, 0, true, false);
+
+	return master_buffer;
+}
+
+static int32_t render_algorithm_5(voice_data_t *p_voice_data, uint8_t feedback_shift, uint32_t voice_start, uint32_t voice_end) {
+	int32_t master_buffer = 0;
+	(void) feedback_shift;
+
+	operator_clear_input(p_voice_data, 0, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 1, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 2, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 3, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 4, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 5, voice_start, voice_end);
+
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 5, OUTPUT_MODE_INDEX_5, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 4, 0, true, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 3, OUTPUT_MODE_INDEX_3, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 2, 0, true, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 1, OUTPUT_MODE_INDEX_1, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 0, 0, true, false);
+
+	return master_buffer;
+}
+
+static int32_t render_algorithm_6(voice_data_t *p_voice_data, uint8_t feedback_shift, uint32_t voice_start, uint32_t voice_end) {
+	int32_t master_buffer = 0;
+
+	operator_clear_input(p_voice_data, 0, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 1, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 2, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 3, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 4, voice_start, voice_end);
+	operator_feedback_input(p_voice_data, 5, feedback_shift, voice_start, voice_end);
+
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 5, OUTPUT_MODE_INDEX_5, false, true);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 4, OUTPUT_MODE_INDEX_3, false, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 3, OUTPUT_MODE_INDEX_3, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 2, 0, true, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 1, OUTPUT_MODE_INDEX_1, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 0, 0, true, false);
+
+	return master_buffer;
+}
+
+static int32_t render_algorithm_7(voice_data_t *p_voice_data, uint8_t feedback_shift, uint32_t voice_start, uint32_t voice_end) {
+	int32_t master_buffer = 0;
+
+	operator_clear_input(p_voice_data, 0, voice_start, voice_end);
+	operator_feedback_input(p_voice_data, 1, feedback_shift, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 2, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 3, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 4, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 5, voice_start, voice_end);
+
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 5, OUTPUT_MODE_INDEX_5, false, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 4, OUTPUT_MODE_INDEX_3, false, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 3, OUTPUT_MODE_INDEX_3, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 2, 0, true, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 1, OUTPUT_MODE_INDEX_1, false, true);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 0, 0, true, false);
+
+	return master_buffer;
+}
+
+static int32_t render_algorithm_8(voice_data_t *p_voice_data, uint8_t feedback_shift, uint32_t voice_start, uint32_t voice_end) {
+	int32_t master_buffer = 0;
+
+	operator_clear_input(p_voice_data, 0, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 1, voice_start, voice_end);
+	operator_feedback_input(p_voice_data, 2, feedback_shift, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 3, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 4, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 5, voice_start, voice_end);
+
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 5, OUTPUT_MODE_INDEX_4, false, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 4, OUTPUT_MODE_INDEX_4, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 3, 0, true, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 2, OUTPUT_MODE_INDEX_2, false, true);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 1, OUTPUT_MODE_INDEX_1, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 0, 0, true, false);
+
+	return master_buffer;
+}
+
+static int32_t render_algorithm_9(voice_data_t *p_voice_data, uint8_t feedback_shift, uint32_t voice_start, uint32_t voice_end) {
+	int32_t master_buffer = 0;
+
+	operator_clear_input(p_voice_data, 0, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 1, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 2, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 3, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 4, voice_start, voice_end);
+	operator_feedback_input(p_voice_data, 5, feedback_shift, voice_start, voice_end);
+
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 5, OUTPUT_MODE_INDEX_4, false, true);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 4, OUTPUT_MODE_INDEX_4, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 3, 0, true, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 2, OUTPUT_MODE_INDEX_2, false, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 1, OUTPUT_MODE_INDEX_1, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 0, 0, true, false);
+
+	return master_buffer;
+}
+
+static int32_t render_algorithm_10(voice_data_t *p_voice_data, uint8_t feedback_shift, uint32_t voice_start, uint32_t voice_end) {
+	int32_t master_buffer = 0;
+
+	operator_clear_input(p_voice_data, 0, voice_start, voice_end);
+	operator_feedback_input(p_voice_data, 1, feedback_shift, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 2, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 3, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 4, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 5, voice_start, voice_end);
+
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 5, OUTPUT_MODE_INDEX_3, false, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 4, OUTPUT_MODE_INDEX_3, false, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 3, OUTPUT_MODE_INDEX_3, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 2, 0, true, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 1, OUTPUT_MODE_INDEX_1, false, true);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 0, 0, true, false);
+
+	return master_buffer;
+}
+
+static int32_t render_algorithm_11(voice_data_t *p_voice_data, uint8_t feedback_shift, uint32_t voice_start, uint32_t voice_end) {
+	int32_t master_buffer = 0;
+
+	operator_clear_input(p_voice_data, 0, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 1, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 2, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 3, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 4, voice_start, voice_end);
+	operator_feedback_input(p_voice_data, 5, feedback_shift, voice_start, voice_end);
+
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 5, OUTPUT_MODE_INDEX_3, false, true);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 4, OUTPUT_MODE_INDEX_3, false, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 3, OUTPUT_MODE_INDEX_3, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 2, 0, true, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 1, OUTPUT_MODE_INDEX_1, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 0, 0, true, false);
+
+	return master_buffer;
+}
+
+static int32_t render_algorithm_12(voice_data_t *p_voice_data, uint8_t feedback_shift, uint32_t voice_start, uint32_t voice_end) {
+	int32_t master_buffer = 0;
+
+	operator_clear_input(p_voice_data, 0, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 1, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 2, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 3, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 4, voice_start, voice_end);
+	operator_feedback_input(p_voice_data, 5, feedback_shift, voice_start, voice_end);
+
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 5, OUTPUT_MODE_INDEX_4, false, true);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 4, OUTPUT_MODE_INDEX_4, false, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 3, OUTPUT_MODE_INDEX_3, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 2, 0, true, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 1, OUTPUT_MODE_INDEX_1, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 0, 0, true, false);
+
+	return master_buffer;
+}
+
+static int32_t render_algorithm_13(voice_data_t *p_voice_data, uint8_t feedback_shift, uint32_t voice_start, uint32_t voice_end) {
+	int32_t master_buffer = 0;
+
+	operator_clear_input(p_voice_data, 0, voice_start, voice_end);
+	operator_feedback_input(p_voice_data, 1, feedback_shift, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 2, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 3, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 4, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 5, voice_start, voice_end);
+
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 5, OUTPUT_MODE_INDEX_4, false, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 4, OUTPUT_MODE_INDEX_4, false, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 3, OUTPUT_MODE_INDEX_3, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 2, 0, true, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 1, OUTPUT_MODE_INDEX_1, false, true);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 0, 0, true, false);
+
+	return master_buffer;
+}
+
+static int32_t render_algorithm_14(voice_data_t *p_voice_data, uint8_t feedback_shift, uint32_t voice_start, uint32_t voice_end) {
+	int32_t master_buffer = 0;
+
+	operator_clear_input(p_voice_data, 0, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 1, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 2, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 3, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 4, voice_start, voice_end);
+	operator_feedback_input(p_voice_data, 5, feedback_shift, voice_start, voice_end);
+
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 5, OUTPUT_MODE_INDEX_5, false, true);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 4, OUTPUT_MODE_INDEX_1, false, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 3, OUTPUT_MODE_INDEX_3, false, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 2, OUTPUT_MODE_INDEX_1, false, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 1, OUTPUT_MODE_INDEX_1, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 0, 0, true, false);
+
+	return master_buffer;
+}
+
+static int32_t render_algorithm_15(voice_data_t *p_voice_data, uint8_t feedback_shift, uint32_t voice_start, uint32_t voice_end) {
+	int32_t master_buffer = 0;
+
+	operator_clear_input(p_voice_data, 0, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 1, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 2, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 3, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 4, voice_start, voice_end);
+	operator_feedback_input(p_voice_data, 5, feedback_shift, voice_start, voice_end);
+
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 5, OUTPUT_MODE_INDEX_1, false, true);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 4, OUTPUT_MODE_INDEX_4, false, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 3, OUTPUT_MODE_INDEX_1, false, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 2, OUTPUT_MODE_INDEX_2, false, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 1, OUTPUT_MODE_INDEX_1, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 0, 0, true, false);
+
+	return master_buffer;
+}
+
+static int32_t render_algorithm_16(voice_data_t *p_voice_data, uint8_t feedback_shift, uint32_t voice_start, uint32_t voice_end) {
+	int32_t master_buffer = 0;
+
+	operator_clear_input(p_voice_data, 0, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 1, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 2, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 3, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 4, voice_start, voice_end);
+	operator_feedback_input(p_voice_data, 5, feedback_shift, voice_start, voice_end);
+
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 5, OUTPUT_MODE_INDEX_4 | OUTPUT_MODE_INDEX_5, false, true);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 4, 0, true, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 3, 0, true, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 2, OUTPUT_MODE_INDEX_2, false, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 1, OUTPUT_MODE_INDEX_1, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 0, 0, true, false);
+
+	return master_buffer;
+}
+
+static int32_t render_algorithm_17(voice_data_t *p_voice_data, uint8_t feedback_shift, uint32_t voice_start, uint32_t voice_end) {
+	int32_t master_buffer = 0;
+
+	operator_clear_input(p_voice_data, 0, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 1, voice_start, voice_end);
+	operator_feedback_input(p_voice_data, 2, feedback_shift, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 3, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 4, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 5, voice_start, voice_end);
+
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 5, OUTPUT_MODE_INDEX_5, false, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 4, OUTPUT_MODE_INDEX_4, false, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 3, OUTPUT_MODE_INDEX_1, false, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 2, OUTPUT_MODE_INDEX_1, false, true);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 1, OUTPUT_MODE_INDEX_1, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 0, 0, true, false);
+
+	return master_buffer;
+}
+
+static int32_t render_algorithm_18(voice_data_t *p_voice_data, uint8_t feedback_shift, uint32_t voice_start, uint32_t voice_end) {
+	int32_t master_buffer = 0;
+
+	operator_clear_input(p_voice_data, 0, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 1, voice_start, voice_end);
+	operator_feedback_input(p_voice_data, 2, feedback_shift, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 3, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 4, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 5, voice_start, voice_end);
+
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 5, OUTPUT_MODE_INDEX_4 | OUTPUT_MODE_INDEX_5, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 4, 0, true, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 3, 0, true, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 2, OUTPUT_MODE_INDEX_1 | OUTPUT_MODE_INDEX_2, false, true);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 1, 0, true, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 0, 0, true, false);
+
+	return master_buffer;
+}
+
+static int32_t render_algorithm_19(voice_data_t *p_voice_data, uint8_t feedback_shift, uint32_t voice_start, uint32_t voice_end) {
+	int32_t master_buffer = 0;
+
+	operator_clear_input(p_voice_data, 0, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 1, voice_start, voice_end);
+	operator_feedback_input(p_voice_data, 2, feedback_shift, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 3, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 4, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 5, voice_start, voice_end);
+
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 5, OUTPUT_MODE_INDEX_4, false, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 4, OUTPUT_MODE_INDEX_4, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 3, 0, true, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 2, OUTPUT_MODE_INDEX_1 | OUTPUT_MODE_INDEX_2, false, true);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 1, 0, true, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 0, 0, true, false);
+
+	return master_buffer;
+}
+
+static int32_t render_algorithm_20(voice_data_t *p_voice_data, uint8_t feedback_shift, uint32_t voice_start, uint32_t voice_end) {
+	int32_t master_buffer = 0;
+
+	operator_clear_input(p_voice_data, 0, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 1, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 2, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 3, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 4, voice_start, voice_end);
+	operator_feedback_input(p_voice_data, 5, feedback_shift, voice_start, voice_end);
+
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 5, OUTPUT_MODE_INDEX_3 | OUTPUT_MODE_INDEX_4 | OUTPUT_MODE_INDEX_5, false, true);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 4, 0, true, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 3, 0, true, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 2, 0, true, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 1, OUTPUT_MODE_INDEX_1, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 0, 0, true, false);
+
+	return master_buffer;
+}
+
+static int32_t render_algorithm_21(voice_data_t *p_voice_data, uint8_t feedback_shift, uint32_t voice_start, uint32_t voice_end) {
+	int32_t master_buffer = 0;
+
+	operator_clear_input(p_voice_data, 0, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 1, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 2, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 3, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 4, voice_start, voice_end);
+	operator_feedback_input(p_voice_data, 5, feedback_shift, voice_start, voice_end);
+
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 5, OUTPUT_MODE_INDEX_4 | OUTPUT_MODE_INDEX_5, false, true);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 4, 0, true, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 3, 0, true, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 2, 0, true, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 1, 0, true, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 0, 0, true, false);
+
+	return master_buffer;
+}
+
+static int32_t render_algorithm_22(voice_data_t *p_voice_data, uint8_t feedback_shift, uint32_t voice_start, uint32_t voice_end) {
+	int32_t master_buffer = 0;
+
+	operator_clear_input(p_voice_data, 0, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 1, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 2, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 3, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 4, voice_start, voice_end);
+	operator_feedback_input(p_voice_data, 5, feedback_shift, voice_start, voice_end);
+
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 5, OUTPUT_MODE_INDEX_4 | OUTPUT_MODE_INDEX_5, false, true);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 4, 0, true, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 3, 0, true, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 2, OUTPUT_MODE_INDEX_2, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 1, 0, true, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 0, 0, true, false);
+
+	return master_buffer;
+}
+
+static int32_t render_algorithm_23(voice_data_t *p_voice_data, uint8_t feedback_shift, uint32_t voice_start, uint32_t voice_end) {
+	int32_t master_buffer = 0;
+
+	operator_clear_input(p_voice_data, 0, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 1, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 2, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 3, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 4, voice_start, voice_end);
+	operator_feedback_input(p_voice_data, 5, feedback_shift, voice_start, voice_end);
+
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 5, OUTPUT_MODE_INDEX_3 | OUTPUT_MODE_INDEX_4 | OUTPUT_MODE_INDEX_5, false, true);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 4, 0, true, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 3, 0, true, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 2, 0, true, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 1, 0, true, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 0, 0, true, false);
+
+	return master_buffer;
+}
+
+static int32_t render_algorithm_24(voice_data_t *p_voice_data, uint8_t feedback_shift, uint32_t voice_start, uint32_t voice_end) {
+	int32_t master_buffer = 0;
+
+	operator_clear_input(p_voice_data, 0, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 1, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 2, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 3, voice_start, voice_end);
+	operator_feedback_input(p_voice_data, 4, feedback_shift, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 5, voice_start, voice_end);
+
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 5, 0, true, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 4, OUTPUT_MODE_INDEX_4, false, true);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 3, OUTPUT_MODE_INDEX_3, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 2, 0, true, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 1, OUTPUT_MODE_INDEX_1, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 0, 0, true, false);
+
+	return master_buffer;
+}
+
+static int32_t render_algorithm_25(voice_data_t *p_voice_data, uint8_t feedback_shift, uint32_t voice_start, uint32_t voice_end) {
+	int32_t master_buffer = 0;
+
+	operator_clear_input(p_voice_data, 0, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 1, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 2, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 3, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 4, voice_start, voice_end);
+	operator_feedback_input(p_voice_data, 5, feedback_shift, voice_start, voice_end);
+
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 5, OUTPUT_MODE_INDEX_5, false, true);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 4, 0, true, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 3, OUTPUT_MODE_INDEX_3, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 2, 0, true, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 1, 0, true, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 0, 0, true, false);
+
+	return master_buffer;
+}
+
+static int32_t render_algorithm_26(voice_data_t *p_voice_data, uint8_t feedback_shift, uint32_t voice_start, uint32_t voice_end) {
+	int32_t master_buffer = 0;
+
+	operator_clear_input(p_voice_data, 0, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 1, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 2, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 3, voice_start, voice_end);
+	operator_feedback_input(p_voice_data, 4, feedback_shift, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 5, voice_start, voice_end);
+
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 5, 0, true, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 4, OUTPUT_MODE_INDEX_4, false, true);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 3, OUTPUT_MODE_INDEX_3, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 2, 0, true, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 1, 0, true, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 0, 0, true, false);
+
+	return master_buffer;
+}
+
+static int32_t render_algorithm_27(voice_data_t *p_voice_data, uint8_t feedback_shift, uint32_t voice_start, uint32_t voice_end) {
+	int32_t master_buffer = 0;
+
+	operator_clear_input(p_voice_data, 0, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 1, voice_start, voice_end);
+	operator_feedback_input(p_voice_data, 2, feedback_shift, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 3, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 4, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 5, voice_start, voice_end);
+
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 5, OUTPUT_MODE_INDEX_4, false, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 4, OUTPUT_MODE_INDEX_4, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 3, 0, true, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 2, OUTPUT_MODE_INDEX_2, false, true);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 1, 0, true, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 0, 0, true, false);
+
+	return master_buffer;
+}
+
+static int32_t render_algorithm_28(voice_data_t *p_voice_data, uint8_t feedback_shift, uint32_t voice_start, uint32_t voice_end) {
+	int32_t master_buffer = 0;
+
+	operator_clear_input(p_voice_data, 0, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 1, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 2, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 3, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 4, voice_start, voice_end);
+	operator_feedback_input(p_voice_data, 5, feedback_shift, voice_start, voice_end);
+
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 5, OUTPUT_MODE_INDEX_4, false, true);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 4, OUTPUT_MODE_INDEX_4, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 3, 0, true, false);
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 2, OUTPUT_MODE_INDEX_2, false, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 1, 0, true, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 0, 0, true, false);
+
+	return master_buffer;
+}
+
+static int32_t render_algorithm_29(voice_data_t *p_voice_data, uint8_t feedback_shift, uint32_t voice_start, uint32_t voice_end) {
+	int32_t master_buffer = 0;
+
+	operator_clear_input(p_voice_data, 0, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 1, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 2, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 3, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 4, voice_start, voice_end);
+	operator_feedback_input(p_voice_data, 5, feedback_shift, voice_start, voice_end);
+
+	operator_sample_voices(p_voice_data, voice_start, voice_end, 5, OUTPUT_MODE_INDEX_5, false, true);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 4, 0, true, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 3, 0, true, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 2, 0, true, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 1, 0, true, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 0, 0, true, false);
+
+	return master_buffer;
+}
+
+static int32_t render_algorithm_30(voice_data_t *p_voice_data, uint8_t feedback_shift, uint32_t voice_start, uint32_t voice_end) {
+	int32_t master_buffer = 0;
+
+	operator_clear_input(p_voice_data, 0, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 1, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 2, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 3, voice_start, voice_end);
+	operator_clear_input(p_voice_data, 4, voice_start, voice_end);
+	operator_feedback_input(p_voice_data, 5, feedback_shift, voice_start, voice_end);
+
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 5, 0, true, true);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 4, 0, true, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 3, 0, true, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 2, 0, true, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 1, 0, true, false);
+	master_buffer += operator_sample_voices(p_voice_data, voice_start, voice_end, 0, 0, true, false);
+
+	return master_buffer;
+}
+
+static const algorithm_kernel_t algorithm_kernels[31] = {
+		render_algorithm_0,
+		render_algorithm_1,
+		render_algorithm_2,
+		render_algorithm_3,
+		render_algorithm_4,
+		render_algorithm_5,
+		render_algorithm_6,
+		render_algorithm_7,
+		render_algorithm_8,
+		render_algorithm_9,
+		render_algorithm_10,
+		render_algorithm_11,
+		render_algorithm_12,
+		render_algorithm_13,
+		render_algorithm_14,
+		render_algorithm_15,
+		render_algorithm_16,
+		render_algorithm_17,
+		render_algorithm_18,
+		render_algorithm_19,
+		render_algorithm_20,
+		render_algorithm_21,
+		render_algorithm_22,
+		render_algorithm_23,
+		render_algorithm_24,
+		render_algorithm_25,
+		render_algorithm_26,
+		render_algorithm_27,
+		render_algorithm_28,
+		render_algorithm_29,
+		render_algorithm_30,
+};
+
+static const uint8_t algorithm_carrier_masks[31] = {
+		0x05,
+		0x05,
+		0x09,
+		0x09,
+		0x15,
+		0x15,
+		0x05,
+		0x05,
+		0x09,
+		0x09,
+		0x05,
+		0x05,
+		0x05,
+		0x05,
+		0x01,
+		0x01,
+		0x19,
+		0x01,
+		0x1B,
+		0x0B,
+		0x1D,
+		0x1F,
+		0x1B,
+		0x1F,
+		0x25,
+		0x17,
+		0x27,
+		0x0B,
+		0x0B,
+		0x1F,
+		0x3F,
+};
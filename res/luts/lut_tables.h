@@ -0,0 +1,199 @@
+// lut_tables.h: lookup tables compiled in with SYNTH_EMBED_LUTS, generated by generate_luts --c-headers
+
+static const uint32_t note_to_log_freq_table[128] __attribute__((aligned(64))) = {
+		0x03080730, 0x031D5C85, 0x0332B1DA, 0x0348072F, 0x035D5C84, 0x0372B1D9, 0x0388072E, 0x039D5C83,
+		0x03B2B1D8, 0x03C8072D, 0x03DD5C82, 0x03F2B1D7, 0x0408072C, 0x041D5C81, 0x0432B1D6, 0x0448072B,
+		0x045D5C80, 0x0472B1D5, 0x0488072A, 0x049D5C7F, 0x04B2B1D4, 0x04C80729, 0x04DD5C7E, 0x04F2B1D3,
+		0x05080728, 0x051D5C7D, 0x0532B1D2, 0x05480727, 0x055D5C7C, 0x0572B1D1, 0x05880726, 0x059D5C7B,
+		0x05B2B1D0, 0x05C80725, 0x05DD5C7A, 0x05F2B1CF, 0x06080724, 0x061D5C79, 0x0632B1CE, 0x06480723,
+		0x065D5C78, 0x0672B1CD, 0x06880722, 0x069D5C77, 0x06B2B1CC, 0x06C80721, 0x06DD5C76, 0x06F2B1CB,
+		0x07080720, 0x071D5C75, 0x0732B1CA, 0x0748071F, 0x075D5C74, 0x0772B1C9, 0x0788071E, 0x079D5C73,
+		0x07B2B1C8, 0x07C8071D, 0x07DD5C72, 0x07F2B1C7, 0x0808071C, 0x081D5C71, 0x0832B1C6, 0x0848071B,
+		0x085D5C70, 0x0872B1C5, 0x0888071A, 0x089D5C6F, 0x08B2B1C4, 0x08C80719, 0x08DD5C6E, 0x08F2B1C3,
+		0x09080718, 0x091D5C6D, 0x0932B1C2, 0x09480717, 0x095D5C6C, 0x0972B1C1, 0x09880716, 0x099D5C6B,
+		0x09B2B1C0, 0x09C80715, 0x09DD5C6A, 0x09F2B1BF, 0x0A080714, 0x0A1D5C69, 0x0A32B1BE, 0x0A480713,
+		0x0A5D5C68, 0x0A72B1BD, 0x0A880712, 0x0A9D5C67, 0x0AB2B1BC, 0x0AC80711, 0x0ADD5C66, 0x0AF2B1BB,
+		0x0B080710, 0x0B1D5C65, 0x0B32B1BA, 0x0B48070F, 0x0B5D5C64, 0x0B72B1B9, 0x0B88070E, 0x0B9D5C63,
+		0x0BB2B1B8, 0x0BC8070D, 0x0BDD5C62, 0x0BF2B1B7, 0x0C08070C, 0x0C1D5C61, 0x0C32B1B6, 0x0C48070B,
+		0x0C5D5C60, 0x0C72B1B5, 0x0C88070A, 0x0C9D5C5F, 0x0CB2B1B4, 0x0CC80709, 0x0CDD5C5E, 0x0CF2B1B3,
+		0x0D080708, 0x0D1D5C5D, 0x0D32B1B2, 0x0D480707, 0x0D5D5C5C, 0x0D72B1B1, 0x0D880706, 0x0D9D5C5B,
+};
+
+static const uint16_t log_sin_table[256] __attribute__((aligned(64))) = {
+		0x0859, 0x06C3, 0x0607, 0x058B, 0x052E, 0x04E4, 0x04A6, 0x0471,
+		0x0443, 0x041A, 0x03F5, 0x03D3, 0x03B5, 0x0398, 0x037E, 0x0365,
+		0x034E, 0x0339, 0x0324, 0x0311, 0x02FF, 0x02ED, 0x02DC, 0x02CD,
+		0x02BD, 0x02AF, 0x02A0, 0x0293, 0x0286, 0x0279, 0x026D, 0x0261,
+		0x0256, 0x024B, 0x0240, 0x0236, 0x022C, 0x0222, 0x0218, 0x020F,
+		0x0206, 0x01FD, 0x01F5, 0x01EC, 0x01E4, 0x01DC, 0x01D4, 0x01CD,
+		0x01C5, 0x01BE, 0x01B7, 0x01B0, 0x01A9, 0x01A2, 0x019B, 0x0195,
+		0x018F, 0x0188, 0x0182, 0x017C, 0x0177, 0x0171, 0x016B, 0x0166,
+		0x0160, 0x015B, 0x0155, 0x0150, 0x014B, 0x0146, 0x0141, 0x013C,
+		0x0137, 0x0133, 0x012E, 0x0129, 0x0125, 0x0121, 0x011C, 0x0118,
+		0x0114, 0x010F, 0x010B, 0x0107, 0x0103, 0x00FF, 0x00FB, 0x00F8,
+		0x00F4, 0x00F0, 0x00EC, 0x00E9, 0x00E5, 0x00E2, 0x00DE, 0x00DB,
+		0x00D7, 0x00D4, 0x00D1, 0x00CD, 0x00CA, 0x00C7, 0x00C4, 0x00C1,
+		0x00BE, 0x00BB, 0x00B8, 0x00B5, 0x00B2, 0x00AF, 0x00AC, 0x00A9,
+		0x00A7, 0x00A4, 0x00A1, 0x009F, 0x009C, 0x0099, 0x0097, 0x0094,
+		0x0092, 0x008F, 0x008D, 0x008A, 0x0088, 0x0086, 0x0083, 0x0081,
+		0x007F, 0x007D, 0x007A, 0x0078, 0x0076, 0x0074, 0x0072, 0x0070,
+		0x006E, 0x006C, 0x006A, 0x0068, 0x0066, 0x0064, 0x0062, 0x0060,
+		0x005E, 0x005C, 0x005B, 0x0059, 0x0057, 0x0055, 0x0053, 0x0052,
+		0x0050, 0x004E, 0x004D, 0x004B, 0x004A, 0x0048, 0x0046, 0x0045,
+		0x0043, 0x0042, 0x0040, 0x003F, 0x003E, 0x003C, 0x003B, 0x0039,
+		0x0038, 0x0037, 0x0035, 0x0034, 0x0033, 0x0031, 0x0030, 0x002F,
+		0x002E, 0x002D, 0x002B, 0x002A, 0x0029, 0x0028, 0x0027, 0x0026,
+		0x0025, 0x0024, 0x0023, 0x0022, 0x0021, 0x0020, 0x001F, 0x001E,
+		0x001D, 0x001C, 0x001B, 0x001A, 0x0019, 0x0018, 0x0017, 0x0017,
+		0x0016, 0x0015, 0x0014, 0x0014, 0x0013, 0x0012, 0x0011, 0x0011,
+		0x0010, 0x000F, 0x000F, 0x000E, 0x000D, 0x000D, 0x000C, 0x000C,
+		0x000B, 0x000A, 0x000A, 0x0009, 0x0009, 0x0008, 0x0008, 0x0007,
+		0x0007, 0x0007, 0x0006, 0x0006, 0x0005, 0x0005, 0x0005, 0x0004,
+		0x0004, 0x0004, 0x0003, 0x0003, 0x0003, 0x0002, 0x0002, 0x0002,
+		0x0002, 0x0001, 0x0001, 0x0001, 0x0001, 0x0001, 0x0001, 0x0001,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+};
+
+static const uint32_t log_sin_table_32[256] __attribute__((aligned(64))) = {
+		0x00000859, 0x000006C3, 0x00000607, 0x0000058B, 0x0000052E, 0x000004E4, 0x000004A6, 0x00000471,
+		0x00000443, 0x0000041A, 0x000003F5, 0x000003D3, 0x000003B5, 0x00000398, 0x0000037E, 0x00000365,
+		0x0000034E, 0x00000339, 0x00000324, 0x00000311, 0x000002FF, 0x000002ED, 0x000002DC, 0x000002CD,
+		0x000002BD, 0x000002AF, 0x000002A0, 0x00000293, 0x00000286, 0x00000279, 0x0000026D, 0x00000261,
+		0x00000256, 0x0000024B, 0x00000240, 0x00000236, 0x0000022C, 0x00000222, 0x00000218, 0x0000020F,
+		0x00000206, 0x000001FD, 0x000001F5, 0x000001EC, 0x000001E4, 0x000001DC, 0x000001D4, 0x000001CD,
+		0x000001C5, 0x000001BE, 0x000001B7, 0x000001B0, 0x000001A9, 0x000001A2, 0x0000019B, 0x00000195,
+		0x0000018F, 0x00000188, 0x00000182, 0x0000017C, 0x00000177, 0x00000171, 0x0000016B, 0x00000166,
+		0x00000160, 0x0000015B, 0x00000155, 0x00000150, 0x0000014B, 0x00000146, 0x00000141, 0x0000013C,
+		0x00000137, 0x00000133, 0x0000012E, 0x00000129, 0x00000125, 0x00000121, 0x0000011C, 0x00000118,
+		0x00000114, 0x0000010F, 0x0000010B, 0x00000107, 0x00000103, 0x000000FF, 0x000000FB, 0x000000F8,
+		0x000000F4, 0x000000F0, 0x000000EC, 0x000000E9, 0x000000E5, 0x000000E2, 0x000000DE, 0x000000DB,
+		0x000000D7, 0x000000D4, 0x000000D1, 0x000000CD, 0x000000CA, 0x000000C7, 0x000000C4, 0x000000C1,
+		0x000000BE, 0x000000BB, 0x000000B8, 0x000000B5, 0x000000B2, 0x000000AF, 0x000000AC, 0x000000A9,
+		0x000000A7, 0x000000A4, 0x000000A1, 0x0000009F, 0x0000009C, 0x00000099, 0x00000097, 0x00000094,
+		0x00000092, 0x0000008F, 0x0000008D, 0x0000008A, 0x00000088, 0x00000086, 0x00000083, 0x00000081,
+		0x0000007F, 0x0000007D, 0x0000007A, 0x00000078, 0x00000076, 0x00000074, 0x00000072, 0x00000070,
+		0x0000006E, 0x0000006C, 0x0000006A, 0x00000068, 0x00000066, 0x00000064, 0x00000062, 0x00000060,
+		0x0000005E, 0x0000005C, 0x0000005B, 0x00000059, 0x00000057, 0x00000055, 0x00000053, 0x00000052,
+		0x00000050, 0x0000004E, 0x0000004D, 0x0000004B, 0x0000004A, 0x00000048, 0x00000046, 0x00000045,
+		0x00000043, 0x00000042, 0x00000040, 0x0000003F, 0x0000003E, 0x0000003C, 0x0000003B, 0x00000039,
+		0x00000038, 0x00000037, 0x00000035, 0x00000034, 0x00000033, 0x00000031, 0x00000030, 0x0000002F,
+		0x0000002E, 0x0000002D, 0x0000002B, 0x0000002A, 0x00000029, 0x00000028, 0x00000027, 0x00000026,
+		0x00000025, 0x00000024, 0x00000023, 0x00000022, 0x00000021, 0x00000020, 0x0000001F, 0x0000001E,
+		0x0000001D, 0x0000001C, 0x0000001B, 0x0000001A, 0x00000019, 0x00000018, 0x00000017, 0x00000017,
+		0x00000016, 0x00000015, 0x00000014, 0x00000014, 0x00000013, 0x00000012, 0x00000011, 0x00000011,
+		0x00000010, 0x0000000F, 0x0000000F, 0x0000000E, 0x0000000D, 0x0000000D, 0x0000000C, 0x0000000C,
+		0x0000000B, 0x0000000A, 0x0000000A, 0x00000009, 0x00000009, 0x00000008, 0x00000008, 0x00000007,
+		0x00000007, 0x00000007, 0x00000006, 0x00000006, 0x00000005, 0x00000005, 0x00000005, 0x00000004,
+		0x00000004, 0x00000004, 0x00000003, 0x00000003, 0x00000003, 0x00000002, 0x00000002, 0x00000002,
+		0x00000002, 0x00000001, 0x00000001, 0x00000001, 0x00000001, 0x00000001, 0x00000001, 0x00000001,
+		0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+};
+
+static const uint16_t exp_table[256] __attribute__((aligned(64))) = {
+		0x0000, 0x0003, 0x0006, 0x0008, 0x000B, 0x000E, 0x0011, 0x0014,
+		0x0016, 0x0019, 0x001C, 0x001F, 0x0022, 0x0025, 0x0028, 0x002A,
+		0x002D, 0x0030, 0x0033, 0x0036, 0x0039, 0x003C, 0x003F, 0x0042,
+		0x0045, 0x0048, 0x004B, 0x004E, 0x0051, 0x0054, 0x0057, 0x005A,
+		0x005D, 0x0060, 0x0063, 0x0066, 0x0069, 0x006C, 0x006F, 0x0072,
+		0x0075, 0x0078, 0x007B, 0x007E, 0x0082, 0x0085, 0x0088, 0x008B,
+		0x008E, 0x0091, 0x0094, 0x0098, 0x009B, 0x009E, 0x00A1, 0x00A4,
+		0x00A8, 0x00AB, 0x00AE, 0x00B1, 0x00B5, 0x00B8, 0x00BB, 0x00BE,
+		0x00C2, 0x00C5, 0x00C8, 0x00CC, 0x00CF, 0x00D2, 0x00D6, 0x00D9,
+		0x00DC, 0x00E0, 0x00E3, 0x00E7, 0x00EA, 0x00ED, 0x00F1, 0x00F4,
+		0x00F8, 0x00FB, 0x00FF, 0x0102, 0x0106, 0x0109, 0x010C, 0x0110,
+		0x0114, 0x0117, 0x011B, 0x011E, 0x0122, 0x0125, 0x0129, 0x012C,
+		0x0130, 0x0134, 0x0137, 0x013B, 0x013E, 0x0142, 0x0146, 0x0149,
+		0x014D, 0x0151, 0x0154, 0x0158, 0x015C, 0x0160, 0x0163, 0x0167,
+		0x016B, 0x016F, 0x0172, 0x0176, 0x017A, 0x017E, 0x0181, 0x0185,
+		0x0189, 0x018D, 0x0191, 0x0195, 0x0199, 0x019C, 0x01A0, 0x01A4,
+		0x01A8, 0x01AC, 0x01B0, 0x01B4, 0x01B8, 0x01BC, 0x01C0, 0x01C4,
+		0x01C8, 0x01CC, 0x01D0, 0x01D4, 0x01D8, 0x01DC, 0x01E0, 0x01E4,
+		0x01E8, 0x01EC, 0x01F0, 0x01F5, 0x01F9, 0x01FD, 0x0201, 0x0205,
+		0x0209, 0x020E, 0x0212, 0x0216, 0x021A, 0x021E, 0x0223, 0x0227,
+		0x022B, 0x0230, 0x0234, 0x0238, 0x023C, 0x0241, 0x0245, 0x0249,
+		0x024E, 0x0252, 0x0257, 0x025B, 0x025F, 0x0264, 0x0268, 0x026D,
+		0x0271, 0x0276, 0x027A, 0x027F, 0x0283, 0x0288, 0x028C, 0x0291,
+		0x0295, 0x029A, 0x029E, 0x02A3, 0x02A8, 0x02AC, 0x02B1, 0x02B5,
+		0x02BA, 0x02BF, 0x02C4, 0x02C8, 0x02CD, 0x02D2, 0x02D6, 0x02DB,
+		0x02E0, 0x02E5, 0x02E9, 0x02EE, 0x02F3, 0x02F8, 0x02FD, 0x0302,
+		0x0306, 0x030B, 0x0310, 0x0315, 0x031A, 0x031F, 0x0324, 0x0329,
+		0x032E, 0x0333, 0x0338, 0x033D, 0x0342, 0x0347, 0x034C, 0x0351,
+		0x0356, 0x035B, 0x0360, 0x0365, 0x036A, 0x0370, 0x0375, 0x037A,
+		0x037F, 0x0384, 0x038A, 0x038F, 0x0394, 0x0399, 0x039F, 0x03A4,
+		0x03A9, 0x03AE, 0x03B4, 0x03B9, 0x03BF, 0x03C4, 0x03C9, 0x03CF,
+		0x03D4, 0x03DA, 0x03DF, 0x03E4, 0x03EA, 0x03EF, 0x03F5, 0x03FA,
+};
+
+static const uint32_t exp_table_32[256] __attribute__((aligned(64))) = {
+		0x00000000, 0x00000003, 0x00000006, 0x00000008, 0x0000000B, 0x0000000E, 0x00000011, 0x00000014,
+		0x00000016, 0x00000019, 0x0000001C, 0x0000001F, 0x00000022, 0x00000025, 0x00000028, 0x0000002A,
+		0x0000002D, 0x00000030, 0x00000033, 0x00000036, 0x00000039, 0x0000003C, 0x0000003F, 0x00000042,
+		0x00000045, 0x00000048, 0x0000004B, 0x0000004E, 0x00000051, 0x00000054, 0x00000057, 0x0000005A,
+		0x0000005D, 0x00000060, 0x00000063, 0x00000066, 0x00000069, 0x0000006C, 0x0000006F, 0x00000072,
+		0x00000075, 0x00000078, 0x0000007B, 0x0000007E, 0x00000082, 0x00000085, 0x00000088, 0x0000008B,
+		0x0000008E, 0x00000091, 0x00000094, 0x00000098, 0x0000009B, 0x0000009E, 0x000000A1, 0x000000A4,
+		0x000000A8, 0x000000AB, 0x000000AE, 0x000000B1, 0x000000B5, 0x000000B8, 0x000000BB, 0x000000BE,
+		0x000000C2, 0x000000C5, 0x000000C8, 0x000000CC, 0x000000CF, 0x000000D2, 0x000000D6, 0x000000D9,
+		0x000000DC, 0x000000E0, 0x000000E3, 0x000000E7, 0x000000EA, 0x000000ED, 0x000000F1, 0x000000F4,
+		0x000000F8, 0x000000FB, 0x000000FF, 0x00000102, 0x00000106, 0x00000109, 0x0000010C, 0x00000110,
+		0x00000114, 0x00000117, 0x0000011B, 0x0000011E, 0x00000122, 0x00000125, 0x00000129, 0x0000012C,
+		0x00000130, 0x00000134, 0x00000137, 0x0000013B, 0x0000013E, 0x00000142, 0x00000146, 0x00000149,
+		0x0000014D, 0x00000151, 0x00000154, 0x00000158, 0x0000015C, 0x00000160, 0x00000163, 0x00000167,
+		0x0000016B, 0x0000016F, 0x00000172, 0x00000176, 0x0000017A, 0x0000017E, 0x00000181, 0x00000185,
+		0x00000189, 0x0000018D, 0x00000191, 0x00000195, 0x00000199, 0x0000019C, 0x000001A0, 0x000001A4,
+		0x000001A8, 0x000001AC, 0x000001B0, 0x000001B4, 0x000001B8, 0x000001BC, 0x000001C0, 0x000001C4,
+		0x000001C8, 0x000001CC, 0x000001D0, 0x000001D4, 0x000001D8, 0x000001DC, 0x000001E0, 0x000001E4,
+		0x000001E8, 0x000001EC, 0x000001F0, 0x000001F5, 0x000001F9, 0x000001FD, 0x00000201, 0x00000205,
+		0x00000209, 0x0000020E, 0x00000212, 0x00000216, 0x0000021A, 0x0000021E, 0x00000223, 0x00000227,
+		0x0000022B, 0x00000230, 0x00000234, 0x00000238, 0x0000023C, 0x00000241, 0x00000245, 0x00000249,
+		0x0000024E, 0x00000252, 0x00000257, 0x0000025B, 0x0000025F, 0x00000264, 0x00000268, 0x0000026D,
+		0x00000271, 0x00000276, 0x0000027A, 0x0000027F, 0x00000283, 0x00000288, 0x0000028C, 0x00000291,
+		0x00000295, 0x0000029A, 0x0000029E, 0x000002A3, 0x000002A8, 0x000002AC, 0x000002B1, 0x000002B5,
+		0x000002BA, 0x000002BF, 0x000002C4, 0x000002C8, 0x000002CD, 0x000002D2, 0x000002D6, 0x000002DB,
+		0x000002E0, 0x000002E5, 0x000002E9, 0x000002EE, 0x000002F3, 0x000002F8, 0x000002FD, 0x00000302,
+		0x00000306, 0x0000030B, 0x00000310, 0x00000315, 0x0000031A, 0x0000031F, 0x00000324, 0x00000329,
+		0x0000032E, 0x00000333, 0x00000338, 0x0000033D, 0x00000342, 0x00000347, 0x0000034C, 0x00000351,
+		0x00000356, 0x0000035B, 0x00000360, 0x00000365, 0x0000036A, 0x00000370, 0x00000375, 0x0000037A,
+		0x0000037F, 0x00000384, 0x0000038A, 0x0000038F, 0x00000394, 0x00000399, 0x0000039F, 0x000003A4,
+		0x000003A9, 0x000003AE, 0x000003B4, 0x000003B9, 0x000003BF, 0x000003C4, 0x000003C9, 0x000003CF,
+		0x000003D4, 0x000003DA, 0x000003DF, 0x000003E4, 0x000003EA, 0x000003EF, 0x000003F5, 0x000003FA,
+};
+
+static const int32_t coarse_log_mult_table[32] __attribute__((aligned(64))) = {
+		-16777216, 0, 16777216, 26591258, 33554432, 38955489, 43368474, 47099599,
+		50331648, 53182516, 55732705, 58039631, 60145690, 62083076, 63876815, 65546747,
+		67108864, 68576246, 69959732, 71268397, 72509921, 73690858, 74816847, 75892776,
+		76922906, 77910978, 78860292, 79773774, 80654031, 81503396, 82323963, 83117621,
+};
+
+static const uint32_t fine_log_mult_table[100] __attribute__((aligned(64))) = {
+		0x00000000, 0x0003ACC9, 0x0007504E, 0x000AEABD, 0x000E7C42, 0x00120508, 0x0015853C, 0x0018FD05,
+		0x001C6C8C, 0x001FD3F7, 0x0023336E, 0x00268B14, 0x0029DB0D, 0x002D237D, 0x00306485, 0x00339E46,
+		0x0036D0E2, 0x0039FC76, 0x003D2122, 0x00403F04, 0x00435639, 0x004666DC, 0x0049710A, 0x004C74DF,
+		0x004F7273, 0x005269E1, 0x00555B42, 0x005846AE, 0x005B2C3D, 0x005E0C07, 0x0060E623, 0x0063BAA6,
+		0x006689A7, 0x0069533A, 0x006C1776, 0x006ED66D, 0x00719034, 0x007444DF, 0x0076F47F, 0x00799F29,
+		0x007C44EE, 0x007EE5E0, 0x00818211, 0x00841991, 0x0086AC72, 0x00893AC3, 0x008BC495, 0x008E49F7,
+		0x0090CAF9, 0x009347AB, 0x0095C01A, 0x00983455, 0x009AA46B, 0x009D1069, 0x009F785D, 0x00A1DC54,
+		0x00A43C5C, 0x00A69881, 0x00A8F0D0, 0x00AB4556, 0x00AD961E, 0x00AFE335, 0x00B22CA6, 0x00B4727D,
+		0x00B6B4C4, 0x00B8F388, 0x00BB2ED3, 0x00BD66AF, 0x00BF9B27, 0x00C1CC46, 0x00C3FA15, 0x00C6249F,
+		0x00C84BED, 0x00CA7009, 0x00CC90FC, 0x00CEAECF, 0x00D0C98D, 0x00D2E13C, 0x00D4F5E8, 0x00D70797,
+		0x00D91653, 0x00DB2224, 0x00DD2B11, 0x00DF3125, 0x00E13465, 0x00E334DB, 0x00E5328D, 0x00E72D84,
+		0x00E925C6, 0x00EB1B5C, 0x00ED0E4C, 0x00EEFE9D, 0x00F0EC57, 0x00F2D781, 0x00F4C020, 0x00F6A63D,
+		0x00F889DD, 0x00FA6B07, 0x00FC49C1, 0x00FE2612,
+};
+
+static const uint8_t level_scale_table[100] __attribute__((aligned(64))) = {
+		0x00, 0x05, 0x09, 0x0D, 0x11, 0x14, 0x17, 0x19,
+		0x1B, 0x1D, 0x1F, 0x21, 0x23, 0x25, 0x27, 0x29,
+		0x2A, 0x2B, 0x2D, 0x2E, 0x30, 0x31, 0x32, 0x33,
+		0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B,
+		0x3C, 0x3D, 0x3E, 0x3F, 0x40, 0x41, 0x42, 0x43,
+		0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4A, 0x4B,
+		0x4C, 0x4D, 0x4E, 0x4F, 0x50, 0x51, 0x52, 0x53,
+		0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x5B,
+		0x5C, 0x5D, 0x5E, 0x5F, 0x60, 0x61, 0x62, 0x63,
+		0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6A, 0x6B,
+		0x6C, 0x6D, 0x6E, 0x6F, 0x70, 0x71, 0x72, 0x73,
+		0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 0x7B,
+		0x7C, 0x7D, 0x7E, 0x7F,
+};
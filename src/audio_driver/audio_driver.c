@@ -9,32 +9,93 @@
 
 static PaStream *stream;
 
-ret_code_t audio_driver_start(void) {
+static int audio_driver_callback(const void *input_buffer, void *output_buffer,
+								 unsigned long frames_per_buffer,
+								 const PaStreamCallbackTimeInfo *time_info,
+								 PaStreamCallbackFlags status_flags,
+								 void *user_data) {
+	(void) input_buffer;
+	(void) time_info;
+	synth_data_t *data = (synth_data_t *) user_data;
+
+	// Underflow: PortAudio inserted silence since the previous callback because it was late
+	uint32_t stream_flags = 0;
+	stream_flags |= status_flags & paOutputUnderflow ? RENDER_STATS_FLAG_UNDERFLOW : 0;
+	stream_flags |= status_flags & paOutputOverflow ? RENDER_STATS_FLAG_OVERFLOW : 0;
+	if (stream_flags != 0) {
+		render_stats_record_stream_flags(&data->render_stats, stream_flags);
+	}
+
+	synthesizer_render_realtime(data, (int32_t *) output_buffer, frames_per_buffer);
+
+	return paContinue;
+}
+
+static void audio_driver_get_output_parameters(PaStreamParameters *p_parameters, PaDeviceIndex device) {
+	p_parameters->device = device;
+	p_parameters->channelCount = 2;
+	p_parameters->sampleFormat = paInt32;
+	p_parameters->suggestedLatency = Pa_GetDeviceInfo(device)->defaultLowOutputLatency;
+	p_parameters->hostApiSpecificStreamInfo = NULL;
+}
+
+/**
+ * @brief Initialize PortAudio and pick the sample rate of the default output device. AUDIO_SAMPLE_RATE is used when
+ * the device supports it, otherwise the default rate of the device, so the stream never runs through a resampler.
+ *
+ * @param p_sample_rate negotiated rate in Hz
+ * @return RET_CODE_OK on success
+ */
+ret_code_t audio_driver_init(uint32_t *p_sample_rate) {
 	PaError err;
 
 	err = Pa_Initialize();
 	if (err != paNoError) return RET_CODE_ERROR;
 
-	PaStreamParameters outputParameters;
-	outputParameters.device = Pa_GetDefaultOutputDevice();
-	if (outputParameters.device == paNoDevice) {
+	PaDeviceIndex device = Pa_GetDefaultOutputDevice();
+	if (device == paNoDevice) {
 		log_error("Error: No default output device.");
 		return RET_CODE_ERROR;
 	}
-	outputParameters.channelCount = 2;
-	outputParameters.sampleFormat = paInt32;
-	outputParameters.suggestedLatency = Pa_GetDeviceInfo(outputParameters.device)->defaultLowOutputLatency;
-	outputParameters.hostApiSpecificStreamInfo = NULL;
+
+	PaStreamParameters outputParameters;
+	audio_driver_get_output_parameters(&outputParameters, device);
+
+	const double candidates[] = {AUDIO_SAMPLE_RATE, Pa_GetDeviceInfo(device)->defaultSampleRate};
+	for (uint32_t i = 0; i < sizeof(candidates) / sizeof(candidates[0]); i++) {
+		uint32_t sample_rate = (uint32_t) candidates[i];
+		if (sample_rate >= AUDIO_MIN_SAMPLE_RATE && sample_rate <= AUDIO_MAX_SAMPLE_RATE &&
+			Pa_IsFormatSupported(NULL, &outputParameters, candidates[i]) == paFormatIsSupported) {
+			*p_sample_rate = sample_rate;
+			return RET_CODE_OK;
+		}
+	}
+
+	log_error("Error: No supported sample rate on the default output device.");
+	return RET_CODE_ERROR;
+}
+
+/**
+ * @brief Open and start the output stream at the rate the engine was initialized with, see audio_driver_init.
+ *
+ * @param data engine
+ * @return RET_CODE_OK on success
+ */
+ret_code_t audio_driver_start(synth_data_t *data) {
+	PaError err;
+
+	PaStreamParameters outputParameters;
+	audio_driver_get_output_parameters(&outputParameters, Pa_GetDefaultOutputDevice());
 
 	err = Pa_OpenStream(
 			&stream,
 			NULL,
 			&outputParameters,
-			AUDIO_SAMPLE_RATE,
+			data->sample_rate,
 			AUDIO_FRAMES_PER_BUFFER,
 			paClipOff,
-			synthesizer_render,
-			&synth_data);
+			audio_driver_callback,
+			data);
 	if (err != paNoError) return RET_CODE_ERROR;
 
 	err = Pa_StartStream(stream);
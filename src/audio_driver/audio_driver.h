@@ -6,8 +6,11 @@
 #define FM_SYNTHESIZER_AUDIO_DRIVER_H
 
 #include "common.h"
+#include "synthesizer.h"
 
-ret_code_t audio_driver_start(void);
+ret_code_t audio_driver_init(uint32_t *p_sample_rate);
+
+ret_code_t audio_driver_start(synth_data_t *data);
 
 ret_code_t audio_driver_stop(void);
 
@@ -0,0 +1,433 @@
+//
+// Created by Tim Holzhey on 17.10.26
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <math.h>
+#include <time.h>
+#include <dirent.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include "common.h"
+#include "synthesizer.h"
+#include "patch_file.h"
+#include "wav_file.h"
+#include "job_queue.h"
+
+#define BATCH_RENDER_BLOCK_FRAMES		256
+#define BATCH_RENDER_BITS_PER_SAMPLE	16
+#define BATCH_RENDER_MAX_PATH			1024
+#define BATCH_RENDER_SUMMARY_FILE		"summary.csv"
+
+typedef enum {
+	BATCH_OUTPUT_WAV,
+	BATCH_OUTPUT_RAW,
+	BATCH_OUTPUT_NONE,
+} batch_output_t;
+
+typedef struct {
+	double time_seconds;
+	uint8_t status;
+	uint8_t key;
+	uint8_t velocity;
+} batch_event_t;
+
+typedef struct {
+	const char *name;
+	double length_seconds;
+	const batch_event_t *p_events;
+	uint32_t num_events;
+} batch_script_t;
+
+static const batch_event_t script_chord[] = {
+		{0.0,	MIDI_STATUS_NOTE_ON,	60, 100},
+		{0.0,	MIDI_STATUS_NOTE_ON,	64, 100},
+		{0.0,	MIDI_STATUS_NOTE_ON,	67, 100},
+		{1.5,	MIDI_STATUS_NOTE_OFF,	60, 0},
+		{1.5,	MIDI_STATUS_NOTE_OFF,	64, 0},
+		{1.5,	MIDI_STATUS_NOTE_OFF,	67, 0},
+};
+
+static const batch_event_t script_scale[] = {
+		{0.00,	MIDI_STATUS_NOTE_ON,	60, 100},
+		{0.25,	MIDI_STATUS_NOTE_OFF,	60, 0},
+		{0.25,	MIDI_STATUS_NOTE_ON,	62, 100},
+		{0.50,	MIDI_STATUS_NOTE_OFF,	62, 0},
+		{0.50,	MIDI_STATUS_NOTE_ON,	64, 100},
+		{0.75,	MIDI_STATUS_NOTE_OFF,	64, 0},
+		{0.75,	MIDI_STATUS_NOTE_ON,	65, 100},
+		{1.00,	MIDI_STATUS_NOTE_OFF,	65, 0},
+		{1.00,	MIDI_STATUS_NOTE_ON,	67, 100},
+		{1.25,	MIDI_STATUS_NOTE_OFF,	67, 0},
+		{1.25,	MIDI_STATUS_NOTE_ON,	69, 100},
+		{1.50,	MIDI_STATUS_NOTE_OFF,	69, 0},
+		{1.50,	MIDI_STATUS_NOTE_ON,	71, 100},
+		{1.75,	MIDI_STATUS_NOTE_OFF,	71, 0},
+		{1.75,	MIDI_STATUS_NOTE_ON,	72, 100},
+		{2.00,	MIDI_STATUS_NOTE_OFF,	72, 0},
+};
+
+static const batch_event_t script_bass[] = {
+		{0.0,	MIDI_STATUS_NOTE_ON,	36, 100},
+		{1.0,	MIDI_STATUS_NOTE_OFF,	36, 0},
+};
+
+#define SCRIPT(_name, _length, _events)		{_name, _length, _events, sizeof(_events) / sizeof(_events[0])}
+
+static const batch_script_t batch_scripts[] = {
+		SCRIPT("chord", 3.0, script_chord),
+		SCRIPT("scale", 3.0, script_scale),
+		SCRIPT("bass", 2.5, script_bass),
+};
+
+#define NUM_BATCH_SCRIPTS				(sizeof(batch_scripts) / sizeof(batch_scripts[0]))
+
+typedef struct {
+	char name[256];
+	voice_params_t voices[PATCH_FILE_NUM_VOICES];
+} batch_bank_t;
+
+typedef struct {
+	double peak;
+	double rms;
+	double render_ms;
+	bool ok;
+} batch_result_t;
+
+static struct {
+	const char *out_dir;
+	batch_output_t output;
+	uint32_t sample_rate;
+	batch_bank_t *p_banks;
+	uint32_t num_banks;
+	const batch_script_t *p_scripts[NUM_BATCH_SCRIPTS];
+	uint32_t num_scripts;
+	uint32_t num_jobs;
+	batch_result_t *p_results;
+	synth_data_t *p_engines;
+	job_queue_t job_queue;
+} m_batch;
+
+static double get_time_seconds(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double) now.tv_sec + (double) now.tv_nsec * 1e-9;
+}
+
+static int compare_strings(const void *p_a, const void *p_b) {
+	return strcmp(*(char *const *) p_a, *(char *const *) p_b);
+}
+
+/**
+ * @brief Decode every .syx file of a directory, in name order. Files that fail to decode are skipped.
+ */
+static ret_code_t batch_load_banks(const char *dir_path) {
+	DIR *dir = opendir(dir_path);
+	if (dir == NULL) {
+		log_error("Failed to open directory: %s", dir_path);
+		return RET_CODE_ERROR;
+	}
+
+	char **file_names = NULL;
+	uint32_t num_files = 0;
+	struct dirent *p_entry;
+	while ((p_entry = readdir(dir)) != NULL) {
+		size_t length = strlen(p_entry->d_name);
+		if (length < 4 || strcasecmp(p_entry->d_name + length - 4, ".syx") != 0) {
+			continue;
+		}
+		char **p_names = realloc(file_names, (num_files + 1) * sizeof(char *));
+		if (p_names == NULL) {
+			break;
+		}
+		file_names = p_names;
+		file_names[num_files++] = strdup(p_entry->d_name);
+	}
+	closedir(dir);
+
+	qsort(file_names, num_files, sizeof(char *), compare_strings);
+
+	m_batch.p_banks = calloc(num_files > 0 ? num_files : 1, sizeof(batch_bank_t));
+	if (m_batch.p_banks == NULL) {
+		log_error("Failed to allocate memory");
+		return RET_CODE_ERROR;
+	}
+
+	for (uint32_t i = 0; i < num_files; i++) {
+		batch_bank_t *p_bank = &m_batch.p_banks[m_batch.num_banks];
+		char file_path[BATCH_RENDER_MAX_PATH];
+		snprintf(file_path, sizeof(file_path), "%s/%s", dir_path, file_names[i]);
+
+		if (patch_file_read_bank(file_path, p_bank->voices) == RET_CODE_OK) {
+			snprintf(p_bank->name, sizeof(p_bank->name), "%.*s", (int) (strlen(file_names[i]) - 4), file_names[i]);
+			m_batch.num_banks++;
+		} else {
+			log_warning("Skipping %s", file_path);
+		}
+		free(file_names[i]);
+	}
+	free(file_names);
+
+	return RET_CODE_OK;
+}
+
+static void batch_get_job(uint32_t job_idx, uint32_t *p_bank, uint32_t *p_voice, uint32_t *p_script) {
+	*p_script = job_idx % m_batch.num_scripts;
+	job_idx /= m_batch.num_scripts;
+	*p_voice = job_idx % PATCH_FILE_NUM_VOICES;
+	*p_bank = job_idx / PATCH_FILE_NUM_VOICES;
+}
+
+/**
+ * @brief Render one (bank, voice, script) job on the engine of a worker.
+ */
+static ret_code_t batch_render_job(synth_data_t *p_engine, uint32_t job_idx, batch_result_t *p_result) {
+	int32_t buffer[BATCH_RENDER_BLOCK_FRAMES * 2];
+	uint32_t bank_idx, voice_idx, script_idx;
+	batch_get_job(job_idx, &bank_idx, &voice_idx, &script_idx);
+	const batch_bank_t *p_bank = &m_batch.p_banks[bank_idx];
+	const batch_script_t *p_script = m_batch.p_scripts[script_idx];
+
+	double start_time = get_time_seconds();
+
+	RET_ON_FAIL(synthesizer_init_engine(p_engine, m_batch.sample_rate));
+	RET_ON_FAIL(synthesizer_set_patch(p_engine, &p_bank->voices[voice_idx]));
+
+	// Opened once nothing can fail before the file is closed again
+	wav_file_t wav_file;
+	if (m_batch.output != BATCH_OUTPUT_NONE) {
+		char file_path[BATCH_RENDER_MAX_PATH];
+		snprintf(file_path, sizeof(file_path), "%s/%s_%02u_%s.%s", m_batch.out_dir, p_bank->name, voice_idx + 1,
+				 p_script->name, m_batch.output == BATCH_OUTPUT_WAV ? "wav" : "raw");
+		if (m_batch.output == BATCH_OUTPUT_WAV) {
+			RET_ON_FAIL(wav_file_open(&wav_file, file_path, m_batch.sample_rate, 2, BATCH_RENDER_BITS_PER_SAMPLE));
+		} else {
+			RET_ON_FAIL(wav_file_open_raw(&wav_file, file_path, m_batch.sample_rate, 2, BATCH_RENDER_BITS_PER_SAMPLE));
+		}
+	}
+
+	uint64_t num_frames = (uint64_t) (p_script->length_seconds * m_batch.sample_rate);
+	uint64_t frame = 0;
+	uint32_t event_idx = 0;
+	double peak = 0.0;
+	double sum_squares = 0.0;
+	ret_code_t ret = RET_CODE_OK;
+
+	while (frame < num_frames && ret == RET_CODE_OK) {
+		// Queue the events of this frame, render up to the next event
+		uint64_t block_end = frame + BATCH_RENDER_BLOCK_FRAMES < num_frames ? frame + BATCH_RENDER_BLOCK_FRAMES : num_frames;
+		while (event_idx < p_script->num_events) {
+			const batch_event_t *p_event = &p_script->p_events[event_idx];
+			uint64_t event_frame = (uint64_t) (p_event->time_seconds * m_batch.sample_rate);
+			if (event_frame > frame) {
+				block_end = event_frame < block_end ? event_frame : block_end;
+				break;
+			}
+			synthesizer_queue_midi_event(p_engine, p_event->status, p_event->key, p_event->velocity);
+			event_idx++;
+		}
+
+		uint32_t block_frames = (uint32_t) (block_end - frame);
+		synthesizer_render_frames(p_engine, buffer, block_frames);
+
+		for (uint32_t i = 0; i < block_frames * 2; i += 2) {
+			double sample = (double) buffer[i] * (1.0 / 2147483648.0);
+			peak = fabs(sample) > peak ? fabs(sample) : peak;
+			sum_squares += sample * sample;
+		}
+
+		if (m_batch.output != BATCH_OUTPUT_NONE) {
+			ret = wav_file_write(&wav_file, buffer, block_frames);
+		}
+		frame = block_end;
+	}
+
+	p_result->render_ms = (get_time_seconds() - start_time) * 1000.0;
+	p_result->peak = peak;
+	p_result->rms = num_frames > 0 ? sqrt(sum_squares / (double) num_frames) : 0.0;
+
+	if (m_batch.output != BATCH_OUTPUT_NONE && wav_file_close(&wav_file) != RET_CODE_OK) {
+		ret = RET_CODE_ERROR;
+	}
+	p_result->ok = ret == RET_CODE_OK;
+
+	return ret;
+}
+
+static void *batch_worker(void *p_arg) {
+	uint32_t worker_idx = (uint32_t) (uintptr_t) p_arg;
+
+	// Every worker renders on its own engine, engines only share the read-only lookup tables
+	synth_data_t *p_engine = &m_batch.p_engines[worker_idx];
+
+	uint32_t job_idx;
+	while (job_queue_pop(&m_batch.job_queue, worker_idx, &job_idx)) {
+		if (batch_render_job(p_engine, job_idx, &m_batch.p_results[job_idx]) != RET_CODE_OK) {
+			log_error("Failed to render job %u", job_idx);
+		}
+	}
+
+	return NULL;
+}
+
+static ret_code_t batch_write_summary(void) {
+	char file_path[BATCH_RENDER_MAX_PATH];
+	snprintf(file_path, sizeof(file_path), "%s/%s", m_batch.out_dir, BATCH_RENDER_SUMMARY_FILE);
+	FILE *file = fopen(file_path, "w");
+	if (file == NULL) {
+		log_error("Failed to open file: %s", file_path);
+		return RET_CODE_ERROR;
+	}
+
+	fprintf(file, "bank,voice,name,script,peak,rms,render_ms,ok\n");
+	for (uint32_t job_idx = 0; job_idx < m_batch.num_jobs; job_idx++) {
+		uint32_t bank_idx, voice_idx, script_idx;
+		batch_get_job(job_idx, &bank_idx, &voice_idx, &script_idx);
+		const batch_bank_t *p_bank = &m_batch.p_banks[bank_idx];
+		const batch_result_t *p_result = &m_batch.p_results[job_idx];
+
+		// Patch names are 10 characters without terminator
+		char name[sizeof(p_bank->voices[0].name) + 1];
+		memcpy(name, p_bank->voices[voice_idx].name, sizeof(p_bank->voices[0].name));
+		name[sizeof(name) - 1] = '\0';
+		for (char *p_char = name; *p_char != '\0'; p_char++) {
+			*p_char = *p_char == '"' || *p_char == ',' ? ' ' : *p_char;
+		}
+
+		fprintf(file, "%s,%u,\"%s\",%s,%.6f,%.6f,%.3f,%u\n", p_bank->name, voice_idx + 1, name,
+				m_batch.p_scripts[script_idx]->name, p_result->peak, p_result->rms, p_result->render_ms, p_result->ok);
+	}
+
+	fclose(file);
+	return RET_CODE_OK;
+}
+
+static void print_usage(const char *program) {
+	fprintf(stderr, "Usage: %s <syx directory> <output directory> [--threads <n>] [--format wav|raw|none] [--sample-rate <hz>] [--script all", program);
+	for (uint32_t i = 0; i < NUM_BATCH_SCRIPTS; i++) {
+		fprintf(stderr, "|%s", batch_scripts[i].name);
+	}
+	fprintf(stderr, "]\n");
+}
+
+int main(int argc, char **argv) {
+	if (argc < 3) {
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	const char *syx_dir = argv[1];
+	const char *script_name = "all";
+	long num_threads = sysconf(_SC_NPROCESSORS_ONLN);
+	m_batch.out_dir = argv[2];
+	m_batch.output = BATCH_OUTPUT_WAV;
+	m_batch.sample_rate = AUDIO_SAMPLE_RATE;
+
+	for (int i = 3; i < argc; i++) {
+		if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+			num_threads = atol(argv[++i]);
+		} else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+			i++;
+			if (strcmp(argv[i], "wav") == 0) {
+				m_batch.output = BATCH_OUTPUT_WAV;
+			} else if (strcmp(argv[i], "raw") == 0) {
+				m_batch.output = BATCH_OUTPUT_RAW;
+			} else if (strcmp(argv[i], "none") == 0) {
+				m_batch.output = BATCH_OUTPUT_NONE;
+			} else {
+				print_usage(argv[0]);
+				return 1;
+			}
+		} else if (strcmp(argv[i], "--sample-rate") == 0 && i + 1 < argc) {
+			m_batch.sample_rate = (uint32_t) atol(argv[++i]);
+		} else if (strcmp(argv[i], "--script") == 0 && i + 1 < argc) {
+			script_name = argv[++i];
+		} else {
+			print_usage(argv[0]);
+			return 1;
+		}
+	}
+
+	for (uint32_t i = 0; i < NUM_BATCH_SCRIPTS; i++) {
+		if (strcmp(script_name, "all") == 0 || strcmp(script_name, batch_scripts[i].name) == 0) {
+			m_batch.p_scripts[m_batch.num_scripts++] = &batch_scripts[i];
+		}
+	}
+	if (m_batch.num_scripts == 0 || num_threads < 1 || num_threads > JOB_QUEUE_MAX_WORKERS) {
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	if (mkdir(m_batch.out_dir, 0755) != 0 && errno != EEXIST) {
+		log_error("Failed to create directory: %s", m_batch.out_dir);
+		return 1;
+	}
+
+	if (batch_load_banks(syx_dir) != RET_CODE_OK) {
+		return 1;
+	}
+
+	m_batch.num_jobs = m_batch.num_banks * PATCH_FILE_NUM_VOICES * m_batch.num_scripts;
+	m_batch.p_results = calloc(m_batch.num_jobs > 0 ? m_batch.num_jobs : 1, sizeof(batch_result_t));
+	if (m_batch.p_results == NULL || job_queue_init(&m_batch.job_queue, m_batch.num_jobs, (uint32_t) num_threads) != RET_CODE_OK) {
+		log_error("Failed to set up %u jobs", m_batch.num_jobs);
+		return 1;
+	}
+
+	// Initializing the engines here also reads the lookup tables shared by all of them and rejects unsupported rates
+	m_batch.p_engines = calloc((size_t) num_threads, sizeof(synth_data_t));
+	if (m_batch.p_engines == NULL) {
+		log_error("Failed to allocate engines");
+		return 1;
+	}
+	for (uint32_t i = 0; i < (uint32_t) num_threads; i++) {
+		if (synthesizer_init_engine(&m_batch.p_engines[i], m_batch.sample_rate) != RET_CODE_OK) {
+			log_error("Failed to initialize synthesizer.")
+			return 1;
+		}
+	}
+
+	double start_time = get_time_seconds();
+
+	pthread_t threads[JOB_QUEUE_MAX_WORKERS];
+	for (uint32_t i = 0; i < (uint32_t) num_threads; i++) {
+		if (pthread_create(&threads[i], NULL, batch_worker, (void *) (uintptr_t) i) != 0) {
+			log_error("Failed to start worker thread %u", i);
+			return 1;
+		}
+	}
+	for (uint32_t i = 0; i < (uint32_t) num_threads; i++) {
+		pthread_join(threads[i], NULL);
+	}
+
+	double elapsed = get_time_seconds() - start_time;
+	job_queue_deinit(&m_batch.job_queue);
+
+	double audio_seconds = 0.0;
+	uint32_t num_failed = 0;
+	for (uint32_t job_idx = 0; job_idx < m_batch.num_jobs; job_idx++) {
+		uint32_t bank_idx, voice_idx, script_idx;
+		batch_get_job(job_idx, &bank_idx, &voice_idx, &script_idx);
+		audio_seconds += m_batch.p_scripts[script_idx]->length_seconds;
+		num_failed += !m_batch.p_results[job_idx].ok;
+	}
+
+	if (batch_write_summary() != RET_CODE_OK) {
+		return 1;
+	}
+
+	printf("Rendered %u jobs (%u banks, %u scripts) on %ld threads in %.2f s, %.1fx realtime, %u failed\n",
+		   m_batch.num_jobs, m_batch.num_banks, m_batch.num_scripts, num_threads, elapsed,
+		   elapsed > 0 ? audio_seconds / elapsed : 0.0, num_failed);
+
+	free(m_batch.p_engines);
+	free(m_batch.p_results);
+	free(m_batch.p_banks);
+
+	return num_failed > 0 ? 1 : 0;
+}
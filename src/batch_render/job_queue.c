@@ -0,0 +1,55 @@
+//
+// Created by Tim Holzhey on 17.10.26
+//
+
+#include "job_queue.h"
+
+ret_code_t job_queue_init(job_queue_t *p_queue, uint32_t num_jobs, uint32_t num_workers) {
+	if (num_workers == 0 || num_workers > JOB_QUEUE_MAX_WORKERS) {
+		log_error("Invalid number of workers: %u", num_workers);
+		return RET_CODE_ERROR;
+	}
+
+	p_queue->num_workers = num_workers;
+	for (uint32_t worker_idx = 0; worker_idx < num_workers; worker_idx++) {
+		job_deque_t *p_deque = &p_queue->deques[worker_idx];
+		pthread_mutex_init(&p_deque->mutex, NULL);
+		p_deque->head = (uint32_t) ((uint64_t) num_jobs * worker_idx / num_workers);
+		p_deque->tail = (uint32_t) ((uint64_t) num_jobs * (worker_idx + 1) / num_workers);
+	}
+
+	return RET_CODE_OK;
+}
+
+void job_queue_deinit(job_queue_t *p_queue) {
+	for (uint32_t worker_idx = 0; worker_idx < p_queue->num_workers; worker_idx++) {
+		pthread_mutex_destroy(&p_queue->deques[worker_idx].mutex);
+	}
+	p_queue->num_workers = 0;
+}
+
+bool job_queue_pop(job_queue_t *p_queue, uint32_t worker_idx, uint32_t *p_job) {
+	// Own jobs first
+	job_deque_t *p_deque = &p_queue->deques[worker_idx];
+	pthread_mutex_lock(&p_deque->mutex);
+	if (p_deque->head < p_deque->tail) {
+		*p_job = p_deque->head++;
+		pthread_mutex_unlock(&p_deque->mutex);
+		return true;
+	}
+	pthread_mutex_unlock(&p_deque->mutex);
+
+	// Steal from the tail of the other workers
+	for (uint32_t i = 1; i < p_queue->num_workers; i++) {
+		p_deque = &p_queue->deques[(worker_idx + i) % p_queue->num_workers];
+		pthread_mutex_lock(&p_deque->mutex);
+		if (p_deque->head < p_deque->tail) {
+			*p_job = --p_deque->tail;
+			pthread_mutex_unlock(&p_deque->mutex);
+			return true;
+		}
+		pthread_mutex_unlock(&p_deque->mutex);
+	}
+
+	return false;
+}
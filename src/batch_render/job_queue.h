@@ -0,0 +1,47 @@
+//
+// Created by Tim Holzhey on 17.10.26
+//
+
+#ifndef FM_SYNTHESIZER_JOB_QUEUE_H
+#define FM_SYNTHESIZER_JOB_QUEUE_H
+
+#include "common.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#define JOB_QUEUE_MAX_WORKERS			256
+
+/**
+ * Jobs of one worker. The owner takes jobs from the head in order, idle workers steal from the tail.
+ * Jobs take milliseconds, so a mutex per deque is cheap compared to the work it hands out.
+ */
+typedef struct {
+	pthread_mutex_t mutex;
+	uint32_t head;
+	uint32_t tail;
+} job_deque_t;
+
+/**
+ * Work-stealing queue of job indices 0..num_jobs - 1. Every worker starts with a contiguous range.
+ */
+typedef struct {
+	job_deque_t deques[JOB_QUEUE_MAX_WORKERS];
+	uint32_t num_workers;
+} job_queue_t;
+
+ret_code_t job_queue_init(job_queue_t *p_queue, uint32_t num_jobs, uint32_t num_workers);
+
+void job_queue_deinit(job_queue_t *p_queue);
+
+/**
+ * @brief Take the next job of a worker, stealing from the other workers when its own range is empty.
+ *
+ * @param p_queue
+ * @param worker_idx 0..num_workers - 1
+ * @param p_job output job index
+ * @return false when no jobs are left
+ */
+bool job_queue_pop(job_queue_t *p_queue, uint32_t worker_idx, uint32_t *p_job);
+
+#endif //FM_SYNTHESIZER_JOB_QUEUE_H
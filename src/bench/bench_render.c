@@ -0,0 +1,293 @@
+//
+// Created by Tim Holzhey on 17.10.26
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "common.h"
+#include "synthesizer.h"
+#include "patch_file.h"
+#include "voice.h"
+
+#define BENCH_DEFAULT_SECONDS			0.5
+#define BENCH_WARMUP_FRAMES				(AUDIO_SAMPLE_RATE / 100)
+#define BENCH_MAX_BUFFER_FRAMES			1024
+#define BENCH_BASE_NOTE					36
+
+static const uint32_t bench_buffer_sizes[] = {16, 32, 64, 128, 256, 512, 1024};
+
+typedef enum {
+	BENCH_OUTPUT_CSV,
+	BENCH_OUTPUT_JSON,
+} bench_output_t;
+
+typedef struct {
+	const char *sweep;
+	patch_file_rom_t rom;
+	uint8_t patch;
+	uint32_t num_voices;
+	int32_t algorithm;
+	int32_t feedback;
+	uint32_t buffer_frames;
+} bench_case_t;
+
+static synth_data_t synth_data;
+
+static struct {
+	bench_output_t output;
+	double seconds;
+	const char *sweep_filter;
+	uint32_t num_threads;
+	uint32_t parallel_min_voices;
+	uint32_t num_results;
+} m_bench;
+
+static double get_time_seconds(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double) now.tv_sec + (double) now.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Load the patch of a case, override algorithm/feedback (-1 = keep) and start the requested number of notes.
+ *
+ * @return number of voices actually playing
+ */
+static uint32_t bench_setup(const bench_case_t *p_case) {
+	int32_t buffer[BENCH_MAX_BUFFER_FRAMES * 2];
+
+	voice_params_t voice_params;
+	patch_file_load_rom(&synth_data.patch_file, p_case->rom);
+	patch_file_load_patch(&synth_data.patch_file, p_case->patch, &voice_params);
+	if (p_case->algorithm >= 0) {
+		voice_params.algorithm = p_case->algorithm;
+	}
+	if (p_case->feedback >= 0) {
+		voice_params.feedback = p_case->feedback;
+	}
+	synthesizer_set_patch(&synth_data, &voice_params);
+
+	voice_init(&synth_data);
+	for (uint32_t i = 0; i < p_case->num_voices; i++) {
+		synthesizer_queue_midi_event(&synth_data, 0x90, (BENCH_BASE_NOTE + i) & 0x7F, 100);
+	}
+	synthesizer_render_frames(&synth_data, buffer, 0);
+
+	uint32_t num_active = 0;
+	for (uint32_t voice_idx = 0; voice_idx < NUM_VOICES; voice_idx++) {
+		num_active += synth_data.voice_data.enable[voice_idx];
+	}
+
+	// Warm up caches and move the envelopes out of the attack
+	for (uint32_t frame = 0; frame < BENCH_WARMUP_FRAMES; frame += p_case->buffer_frames) {
+		synthesizer_render_frames(&synth_data, buffer, p_case->buffer_frames);
+	}
+
+	return num_active;
+}
+
+static void bench_run(const bench_case_t *p_case) {
+	if (m_bench.sweep_filter != NULL && strcmp(m_bench.sweep_filter, p_case->sweep) != 0) {
+		return;
+	}
+
+	int32_t buffer[BENCH_MAX_BUFFER_FRAMES * 2];
+	uint32_t num_active = bench_setup(p_case);
+	uint32_t num_buffers = (uint32_t) (m_bench.seconds * AUDIO_SAMPLE_RATE / p_case->buffer_frames) + 1;
+	uint64_t num_frames = (uint64_t) num_buffers * p_case->buffer_frames;
+
+	synthesizer_cull_counters_t cull_start, cull_end;
+	synthesizer_get_cull_counters(&synth_data, &cull_start);
+
+	double start_time = get_time_seconds();
+	for (uint32_t i = 0; i < num_buffers; i++) {
+		synthesizer_render_frames(&synth_data, buffer, p_case->buffer_frames);
+	}
+	double elapsed = get_time_seconds() - start_time;
+
+	double ns_per_sample = elapsed * 1e9 / (double) num_frames;
+	double ns_per_voice_sample = num_active > 0 ? ns_per_sample / num_active : 0.0;
+	double realtime_factor = elapsed > 0 ? ((double) num_frames / AUDIO_SAMPLE_RATE) / elapsed : 0.0;
+
+	synthesizer_get_cull_counters(&synth_data, &cull_end);
+	const voice_params_t *p_params = synthesizer_get_patch(&synth_data);
+	uint64_t num_operator_samples = cull_end.num_operator_samples - cull_start.num_operator_samples;
+	uint64_t num_culled = cull_end.num_operator_samples_culled - cull_start.num_operator_samples_culled;
+	double culled_fraction = num_operator_samples > 0 ? (double) num_culled / (double) num_operator_samples : 0.0;
+
+	if (m_bench.output == BENCH_OUTPUT_CSV) {
+		printf("%s,%u,%u,%u,%u,%u,%u,%u,%llu,%.2f,%.2f,%.2f,%.4f,%d,%d,%u\n", p_case->sweep, p_case->rom, p_case->patch + 1,
+			   p_case->num_voices, num_active, p_params->algorithm + 1, p_params->feedback,
+			   p_case->buffer_frames, (unsigned long long) num_frames, ns_per_sample, ns_per_voice_sample, realtime_factor,
+			   culled_fraction, SYNTH_SIMD, ENVELOPE_BLOCK_SIZE, m_bench.num_threads);
+	} else {
+		printf("%s\n    {\"sweep\":\"%s\",\"rom\":%u,\"patch\":%u,\"voices_requested\":%u,\"voices_active\":%u,\"algorithm\":%u,"
+			   "\"feedback\":%u,\"buffer_frames\":%u,\"frames\":%llu,\"ns_per_sample\":%.2f,\"ns_per_voice_sample\":%.2f,"
+			   "\"realtime_factor\":%.2f,\"culled_fraction\":%.4f}", m_bench.num_results > 0 ? "," : "", p_case->sweep, p_case->rom,
+			   p_case->patch + 1, p_case->num_voices, num_active, p_params->algorithm + 1, p_params->feedback,
+			   p_case->buffer_frames, (unsigned long long) num_frames, ns_per_sample, ns_per_voice_sample, realtime_factor,
+			   culled_fraction);
+	}
+	fflush(stdout);
+
+	m_bench.num_results++;
+}
+
+#if SYNTH_PROFILE_STAGES
+/**
+ * @brief Print the per-stage render time by algorithm accumulated over all cases, as CSV rows or a JSON array.
+ */
+static void bench_print_profile(FILE *file, bool json) {
+	render_profile_snapshot_t profile;
+	synthesizer_get_render_profile(&synth_data, &profile);
+
+	if (!json) {
+		fprintf(file, "algorithm,frames");
+		for (uint32_t stage = 0; stage < RENDER_STAGE_COUNT; stage++) {
+			fprintf(file, ",%s_%s_per_frame", render_stage_names[stage], RENDER_PROFILE_UNIT);
+		}
+		fprintf(file, "\n");
+	}
+
+	bool first = true;
+	for (uint32_t algorithm = 0; algorithm < RENDER_PROFILE_NUM_ALGORITHMS; algorithm++) {
+		uint64_t num_frames = profile.num_frames[algorithm];
+		if (num_frames == 0) {
+			continue;
+		}
+		if (json) {
+			fprintf(file, "%s\n    {\"algorithm\":%u,\"frames\":%llu", first ? "" : ",", algorithm + 1, (unsigned long long) num_frames);
+		} else {
+			fprintf(file, "%u,%llu", algorithm + 1, (unsigned long long) num_frames);
+		}
+		for (uint32_t stage = 0; stage < RENDER_STAGE_COUNT; stage++) {
+			double per_frame = (double) profile.ticks[algorithm][stage] / (double) num_frames;
+			if (json) {
+				fprintf(file, ",\"%s\":%.1f", render_stage_names[stage], per_frame);
+			} else {
+				fprintf(file, ",%.1f", per_frame);
+			}
+		}
+		fprintf(file, json ? "}" : "\n");
+		first = false;
+	}
+}
+#endif
+
+static void print_usage(const char *program) {
+	fprintf(stderr, "Usage: %s [--json] [--seconds <audio seconds per case>] [--sweep voices|algorithms|feedback|buffers|patches]\n"
+					"       [--threads <worker threads>] [--parallel-min-voices <voices>]\n", program);
+}
+
+int main(int argc, char **argv) {
+	m_bench.output = BENCH_OUTPUT_CSV;
+	m_bench.seconds = BENCH_DEFAULT_SECONDS;
+	m_bench.num_threads = SYNTH_WORKER_THREADS;
+	m_bench.parallel_min_voices = SYNTH_PARALLEL_MIN_VOICES;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--json") == 0) {
+			m_bench.output = BENCH_OUTPUT_JSON;
+		} else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+			m_bench.seconds = atof(argv[++i]);
+		} else if (strcmp(argv[i], "--sweep") == 0 && i + 1 < argc) {
+			m_bench.sweep_filter = argv[++i];
+		} else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+			m_bench.num_threads = (uint32_t) atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--parallel-min-voices") == 0 && i + 1 < argc) {
+			m_bench.parallel_min_voices = (uint32_t) atoi(argv[++i]);
+		} else {
+			print_usage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (synthesizer_init(&synth_data, AUDIO_SAMPLE_RATE) != RET_CODE_OK) {
+		log_error("Failed to initialize synthesizer.")
+		return 1;
+	}
+
+	if (synthesizer_start_workers(&synth_data, m_bench.num_threads, m_bench.parallel_min_voices) != RET_CODE_OK) {
+		log_error("Failed to start worker threads.")
+		return 1;
+	}
+
+	if (m_bench.output == BENCH_OUTPUT_CSV) {
+		printf("sweep,rom,patch,voices_requested,voices_active,algorithm,feedback,buffer_frames,frames,"
+			   "ns_per_sample,ns_per_voice_sample,realtime_factor,culled_fraction,simd,envelope_block_size,threads\n");
+	} else {
+		printf("{\n  \"config\":{\"num_voices\":%u,\"sample_rate\":%u,\"simd\":%d,\"envelope_block_size\":%d,\"threads\":%u},\n  \"results\":[",
+			   NUM_VOICES, AUDIO_SAMPLE_RATE, SYNTH_SIMD, ENVELOPE_BLOCK_SIZE, m_bench.num_threads);
+	}
+
+	bench_case_t bench_case = {
+			.rom = DEFAULT_PATCH_FILE,
+			.patch = DEFAULT_PATCH_FILE_VOICE - 1,
+			.num_voices = NUM_VOICES,
+			.algorithm = -1,
+			.feedback = -1,
+			.buffer_frames = AUDIO_FRAMES_PER_BUFFER,
+	};
+
+	// Voice count, beyond NUM_VOICES the extra notes steal the oldest voices, so voices_active stays at NUM_VOICES
+	bench_case.sweep = "voices";
+	for (uint32_t num_voices = 1; num_voices <= NUM_VOICES * 2; num_voices++) {
+		bench_case.num_voices = num_voices;
+		bench_run(&bench_case);
+	}
+	bench_case.num_voices = NUM_VOICES;
+
+	// Algorithms
+	bench_case.sweep = "algorithms";
+	for (int32_t algorithm = 0; algorithm < 32; algorithm++) {
+		bench_case.algorithm = algorithm;
+		bench_run(&bench_case);
+	}
+	bench_case.algorithm = -1;
+
+	// Feedback levels
+	bench_case.sweep = "feedback";
+	for (int32_t feedback = 0; feedback < 8; feedback++) {
+		bench_case.feedback = feedback;
+		bench_run(&bench_case);
+	}
+	bench_case.feedback = -1;
+
+	// Buffer sizes
+	bench_case.sweep = "buffers";
+	for (uint32_t i = 0; i < sizeof(bench_buffer_sizes) / sizeof(bench_buffer_sizes[0]); i++) {
+		bench_case.buffer_frames = bench_buffer_sizes[i];
+		bench_run(&bench_case);
+	}
+	bench_case.buffer_frames = AUDIO_FRAMES_PER_BUFFER;
+
+	// Every voice of every bank in res/patches
+	bench_case.sweep = "patches";
+	for (uint32_t rom = 0; rom < PATCH_FILE_ROM_COUNT; rom++) {
+		bench_case.rom = rom;
+		for (uint32_t patch = 0; patch < PATCH_FILE_NUM_VOICES; patch++) {
+			bench_case.patch = patch;
+			bench_run(&bench_case);
+		}
+	}
+
+	if (m_bench.output == BENCH_OUTPUT_JSON) {
+#if SYNTH_PROFILE_STAGES
+		printf("\n  ],\n  \"profile_unit\":\"%s\",\n  \"profile\":[", RENDER_PROFILE_UNIT);
+		bench_print_profile(stdout, true);
+#endif
+		printf("\n  ]\n}\n");
+	}
+#if SYNTH_PROFILE_STAGES
+	else {
+		// Keep stdout a single CSV table
+		bench_print_profile(stderr, false);
+	}
+#endif
+
+	synthesizer_stop_workers(&synth_data);
+
+	return 0;
+}
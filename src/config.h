@@ -7,15 +7,93 @@
 
 #include "patch_file.h"
 
+// Default sample rate, engines take the rate the audio device runs at on init
 #define AUDIO_SAMPLE_RATE						44100
+#define AUDIO_MIN_SAMPLE_RATE					8000
+#define AUDIO_MAX_SAMPLE_RATE					192000
+#ifndef AUDIO_FRAMES_PER_BUFFER
 #define AUDIO_FRAMES_PER_BUFFER					64
+#endif
 
+#ifndef NUM_VOICES
 #define NUM_VOICES								16
+#endif
 #define NUM_OPERATORS							6
 
+// What a note-on does when every voice is gated, see voice_steal_policy_t
+#ifndef VOICE_STEAL_POLICY_DEFAULT
+#define VOICE_STEAL_POLICY_DEFAULT				VOICE_STEAL_POLICY_OLDEST
+#endif
+
+// Adaptive polyphony for the real-time stream: the voice limit drops while the smoothed callback load (1000 = the
+// buffer period) is above the high watermark and recovers below the low watermark, offline renders are not governed
+#ifndef VOICE_GOVERNOR_ENABLE
+#define VOICE_GOVERNOR_ENABLE					1
+#endif
+#define VOICE_GOVERNOR_HIGH_LOAD_PERMILLE		800
+#define VOICE_GOVERNOR_LOW_LOAD_PERMILLE		500
+#define VOICE_GOVERNOR_MIN_VOICES				4
+#define VOICE_GOVERNOR_HOLD_CALLBACKS			32
+#define VOICE_GOVERNOR_RESTORE_STEP				((NUM_VOICES + 15) / 16)
+// Voice limit changes are logged by a control thread at this interval, far below the time the event ring covers
+#define VOICE_GOVERNOR_LOG_INTERVAL_MS			100
+
+// Voices are rendered in fixed chunks whose mixes are summed in chunk order, independent of the thread count
+#define RENDER_CHUNK_VOICES						16
+#define NUM_RENDER_CHUNKS						((NUM_VOICES + RENDER_CHUNK_VOICES - 1) / RENDER_CHUNK_VOICES)
+#define RENDER_BLOCK_FRAMES						64
+
+// Worker threads for the voice chunks, 0 = render on the audio thread only
+#ifndef SYNTH_WORKER_THREADS
+#define SYNTH_WORKER_THREADS					0
+#endif
+// Fewer active voices than this are rendered on the audio thread only
+#ifndef SYNTH_PARALLEL_MIN_VOICES
+#define SYNTH_PARALLEL_MIN_VOICES				64
+#endif
+
+// Compile the lookup tables in from res/luts/lut_tables.h instead of reading the .mem files at startup
+#ifndef SYNTH_EMBED_LUTS
+#define SYNTH_EMBED_LUTS						0
+#endif
+
+// Count the time spent per render stage and algorithm (rdtsc on x86), 0 = counters compile to nothing
+#ifndef SYNTH_PROFILE_STAGES
+#define SYNTH_PROFILE_STAGES					0
+#endif
+
+// Evaluate the operator kernel for SIMD_LANES voices at once (AVX2 or NEON), 0 = scalar kernel
+#ifndef SYNTH_SIMD
+#define SYNTH_SIMD								0
+#endif
+#if SYNTH_SIMD && defined(__AVX2__)
+#define SYNTH_SIMD_AVX2							1
+#elif SYNTH_SIMD && defined(__ARM_NEON) && defined(__aarch64__)
+#define SYNTH_SIMD_NEON							1
+#endif
+#define SIMD_LANES								8
+
 #define ENVELOPE_BIT_WIDTH						9
 #define ENVELOPE_MAX							((1 << ENVELOPE_BIT_WIDTH) - 1)
 
+// Frames per envelope control block, 1 = exact per-sample envelope (matches the FPGA)
+#ifndef ENVELOPE_BLOCK_SIZE
+#define ENVELOPE_BLOCK_SIZE						1
+#endif
+#define ENVELOPE_RAMP_FRACTION_BITS				16
+// Envelope rates are per sample at this rate, other rates scale the level steps to keep the timing
+#define ENVELOPE_REFERENCE_SAMPLE_RATE			44100
+#define ENVELOPE_RATE_SCALE_BITS				16
+
+// Operator level (0..ENVELOPE_MAX, loud to quiet) from which the exp table lookup shifts every sample to 0,
+// the renderer skips the sine evaluation of such operators
+#define OPERATOR_SILENT_LEVEL					(((EXP_TABLE_BIT_WIDTH + 2) << EXP_TABLE_LOG_SIZE) >> (ENVELOPE_BIT_WIDTH - 6))
+
+// Retire released voices once every carrier level is at least this (0 = off, OPERATOR_SILENT_LEVEL = inaudible)
+#ifndef VOICE_RETIRE_LEVEL
+#define VOICE_RETIRE_LEVEL						0
+#endif
+
 #define FEEDBACK_BIT_WIDTH						8
 
 #define OSCILLATOR_MODE_RATIO					0
@@ -26,6 +104,9 @@
 #define DEFAULT_PATCH_FILE						PATCH_FILE_ROM_ROM1A
 #define DEFAULT_PATCH_FILE_VOICE				11
 
+// Render plans kept per engine, at least 3 (the rendered, the pending and the one being built)
+#define RENDER_PLAN_CACHE_SIZE					16
+
 #define SAMPLE_BIT_WIDTH						24
 #define SAMPLE_MASK								((1 << SAMPLE_BIT_WIDTH) - 1)
 
@@ -0,0 +1,589 @@
+//
+// Created by Tim Holzhey on 17.10.26
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include "common.h"
+#include "synthesizer.h"
+#include "patch_file.h"
+#include "voice.h"
+
+#define GOLDEN_FILE_PATH				SOURCE_DIR "/res/golden/golden_hashes.txt"
+#define GOLDEN_NUM_FRAMES				16384
+#define GOLDEN_WINDOW_FRAMES			2048
+#define GOLDEN_NUM_WINDOWS				(GOLDEN_NUM_FRAMES / GOLDEN_WINDOW_FRAMES)
+#define GOLDEN_NUM_PATCHES				(PATCH_FILE_ROM_COUNT * PATCH_FILE_NUM_VOICES)
+#define GOLDEN_TRACE_LINE_SIZE			8192
+#define GOLDEN_TRACE_VOICE_SEPARATOR	" |"
+#define GOLDEN_STEAL_PATCH				4	// STRINGS 2 of rom1a, held notes sustain well above the silent level
+#define GOLDEN_STEAL_NUM_KEYS			48
+#define GOLDEN_STEAL_MAX_FRAMES			(AUDIO_SAMPLE_RATE * 10)
+
+#define FNV_OFFSET_BASIS				0xcbf29ce484222325ULL
+#define FNV_PRIME						0x100000001b3ULL
+
+typedef struct {
+	uint32_t frame;
+	uint8_t status;
+	uint8_t key;
+	uint8_t velocity;
+} golden_event_t;
+
+/** Fixed note script: a chord, a late bass note, then releases so all envelope stages are covered */
+static const golden_event_t golden_script[] = {
+		{0,		MIDI_STATUS_NOTE_ON,	60, 100},
+		{0,		MIDI_STATUS_NOTE_ON,	64, 100},
+		{0,		MIDI_STATUS_NOTE_ON,	67, 100},
+		{4096,	MIDI_STATUS_NOTE_ON,	36, 64},
+		{8192,	MIDI_STATUS_NOTE_OFF,	60, 0},
+		{8192,	MIDI_STATUS_NOTE_OFF,	64, 0},
+		{12288,	MIDI_STATUS_NOTE_OFF,	67, 0},
+		{12288,	MIDI_STATUS_NOTE_OFF,	36, 0},
+};
+
+typedef struct {
+	uint64_t output;
+	uint64_t operators[NUM_OPERATORS];
+} golden_window_t;
+
+static synth_data_t synth_data;
+
+static golden_window_t m_golden[PATCH_FILE_ROM_COUNT][PATCH_FILE_NUM_VOICES][GOLDEN_NUM_WINDOWS];
+static golden_window_t m_rendered[PATCH_FILE_ROM_COUNT][PATCH_FILE_NUM_VOICES][GOLDEN_NUM_WINDOWS];
+
+static inline uint64_t hash_word(uint64_t hash, uint32_t word) {
+	for (uint32_t i = 0; i < 4; i++) {
+		hash ^= (word >> (i * 8)) & 0xFF;
+		hash *= FNV_PRIME;
+	}
+	return hash;
+}
+
+// Per-frame trace written with --trace, and the reference trace a mismatching patch is compared against
+static FILE *m_trace_file;
+static FILE *m_reference_file;
+static const char *m_reference_dir;
+static bool m_difference_found;
+
+/**
+ * @brief Check whether a voice contributes to the output: it is enabled and one of its carriers is not silent.
+ * Inaudible voices are left out of the operator hashes, so they do not depend on when voices are retired.
+ */
+static bool golden_voice_is_audible(uint16_t voice_idx) {
+	if (!synth_data.voice_data.enable[voice_idx]) {
+		return false;
+	}
+
+	for (uint32_t operator_idx = 0; operator_idx < NUM_OPERATORS; operator_idx++) {
+		if ((synth_data.p_plan->carrier_mask & (1 << operator_idx)) &&
+			synth_data.voice_data.level[operator_idx][voice_idx] < OPERATOR_SILENT_LEVEL) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * @brief Hash the operator state of the audible voices into the window. Voices are visited by note and then in
+ * allocation order, never by slot, so the hashes do not depend on NUM_VOICES or on which slots were picked.
+ */
+static void golden_hash_operators(golden_window_t *p_window) {
+	const voice_allocator_t *p_alloc = &synth_data.voice_allocator;
+	for (uint32_t note = 0; note < NUM_MIDI_NOTES; note++) {
+		for (uint16_t voice_idx = p_alloc->note_head[note]; voice_idx != VOICE_NONE; voice_idx = p_alloc->note_next[voice_idx]) {
+			if (!golden_voice_is_audible(voice_idx)) {
+				continue;
+			}
+
+			for (uint32_t operator_idx = 0; operator_idx < NUM_OPERATORS; operator_idx++) {
+				uint64_t hash = hash_word(p_window->operators[operator_idx], note);
+				hash = hash_word(hash, synth_data.voice_data.phase[operator_idx][voice_idx]);
+				hash = hash_word(hash, synth_data.voice_data.level[operator_idx][voice_idx]);
+				hash = hash_word(hash, (uint32_t) synth_data.voice_data.input_mod_buffer[operator_idx][voice_idx]);
+				p_window->operators[operator_idx] = hash;
+			}
+		}
+	}
+}
+
+/**
+ * @brief Format the trace line of a frame: frame, output, then per audible voice (same order as the operator
+ * hashes) the note and the phase, level and input modulation of every operator.
+ */
+static void golden_format_trace(char *p_line, uint32_t frame, const int32_t *p_frame_out) {
+	const voice_allocator_t *p_alloc = &synth_data.voice_allocator;
+	int index = snprintf(p_line, GOLDEN_TRACE_LINE_SIZE, "%u %d %d", frame, p_frame_out[0], p_frame_out[1]);
+
+	for (uint32_t note = 0; note < NUM_MIDI_NOTES; note++) {
+		for (uint16_t voice_idx = p_alloc->note_head[note]; voice_idx != VOICE_NONE; voice_idx = p_alloc->note_next[voice_idx]) {
+			if (!golden_voice_is_audible(voice_idx) || index >= GOLDEN_TRACE_LINE_SIZE) {
+				continue;
+			}
+
+			index += snprintf(p_line + index, GOLDEN_TRACE_LINE_SIZE - index, GOLDEN_TRACE_VOICE_SEPARATOR " %u", note);
+			for (uint32_t operator_idx = 0; operator_idx < NUM_OPERATORS && index < GOLDEN_TRACE_LINE_SIZE; operator_idx++) {
+				index += snprintf(p_line + index, GOLDEN_TRACE_LINE_SIZE - index, " %08x %u %d",
+								  synth_data.voice_data.phase[operator_idx][voice_idx],
+								  synth_data.voice_data.level[operator_idx][voice_idx],
+								  synth_data.voice_data.input_mod_buffer[operator_idx][voice_idx]);
+			}
+		}
+	}
+}
+
+typedef struct {
+	uint32_t note;
+	uint32_t phase[NUM_OPERATORS];
+	uint32_t level[NUM_OPERATORS];
+	int32_t input_mod[NUM_OPERATORS];
+} golden_trace_voice_t;
+
+static void golden_print_trace_voice(const golden_trace_voice_t *p_voice, const char *p_description) {
+	printf("  voice note %u is audible %s:", p_voice->note, p_description);
+	for (uint32_t operator_idx = 0; operator_idx < NUM_OPERATORS; operator_idx++) {
+		printf(" op%u %08x %u %d", operator_idx + 1, p_voice->phase[operator_idx], p_voice->level[operator_idx],
+			   p_voice->input_mod[operator_idx]);
+	}
+	printf("\n");
+}
+
+/**
+ * @brief Parse the voice at a position of a trace line.
+ *
+ * @param p_line trace line
+ * @param position 0 = first audible voice
+ * @param p_voice parsed voice
+ * @return false if the line has no voice at that position
+ */
+static bool golden_parse_trace_voice(const char *p_line, uint32_t position, golden_trace_voice_t *p_voice) {
+	const char *p_voice_line = p_line;
+	for (uint32_t i = 0; i <= position; i++) {
+		p_voice_line = strstr(p_voice_line, GOLDEN_TRACE_VOICE_SEPARATOR);
+		if (p_voice_line == NULL) {
+			return false;
+		}
+		p_voice_line += strlen(GOLDEN_TRACE_VOICE_SEPARATOR);
+	}
+
+	int offset = 0;
+	if (sscanf(p_voice_line, "%u%n", &p_voice->note, &offset) != 1) {
+		return false;
+	}
+	p_voice_line += offset;
+	for (uint32_t operator_idx = 0; operator_idx < NUM_OPERATORS; operator_idx++) {
+		if (sscanf(p_voice_line, "%x %u %d%n", &p_voice->phase[operator_idx], &p_voice->level[operator_idx],
+				   &p_voice->input_mod[operator_idx], &offset) != 3) {
+			return false;
+		}
+		p_voice_line += offset;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Report the first voice and its operators that differ between a rendered and a reference trace line.
+ */
+static void golden_report_trace_difference(const char *p_line, const char *p_reference_line) {
+	uint32_t frame;
+	int32_t out_l, out_r, reference_l, reference_r;
+	sscanf(p_line, "%u %d %d", &frame, &out_l, &out_r);
+	if (sscanf(p_reference_line, "%*u %d %d", &reference_l, &reference_r) != 2) {
+		printf("  frame %u: malformed reference trace line\n", frame);
+		return;
+	}
+
+	printf("  first difference at frame %u", frame);
+	if (out_l != reference_l || out_r != reference_r) {
+		printf(", output %d %d (reference %d %d)", out_l, out_r, reference_l, reference_r);
+	}
+	printf("\n");
+
+	for (uint32_t position = 0;; position++) {
+		golden_trace_voice_t voice, reference_voice;
+		bool has_voice = golden_parse_trace_voice(p_line, position, &voice);
+		bool has_reference_voice = golden_parse_trace_voice(p_reference_line, position, &reference_voice);
+		if (!has_voice && !has_reference_voice) {
+			return;
+		}
+		if (!has_reference_voice || (has_voice && voice.note < reference_voice.note)) {
+			golden_print_trace_voice(&voice, "here, silent or missing in the reference");
+			return;
+		}
+		if (!has_voice || reference_voice.note < voice.note) {
+			golden_print_trace_voice(&reference_voice, "in the reference only");
+			return;
+		}
+
+		if (memcmp(&voice, &reference_voice, sizeof(voice)) == 0) {
+			continue;
+		}
+
+		for (uint32_t operator_idx = 0; operator_idx < NUM_OPERATORS; operator_idx++) {
+			if (voice.phase[operator_idx] != reference_voice.phase[operator_idx] ||
+				voice.level[operator_idx] != reference_voice.level[operator_idx] ||
+				voice.input_mod[operator_idx] != reference_voice.input_mod[operator_idx]) {
+				printf("  voice note %u op%u: phase %08x level %u input %d (reference %08x %u %d)\n", voice.note, operator_idx + 1,
+					   voice.phase[operator_idx], voice.level[operator_idx], voice.input_mod[operator_idx],
+					   reference_voice.phase[operator_idx], reference_voice.level[operator_idx], reference_voice.input_mod[operator_idx]);
+			}
+		}
+		return;
+	}
+}
+
+/**
+ * @brief Write the trace line of a frame, or compare it with the reference trace and report the first difference.
+ */
+static void golden_trace_frame(uint32_t frame, const int32_t *p_frame_out) {
+	static char line[GOLDEN_TRACE_LINE_SIZE];
+	static char reference_line[GOLDEN_TRACE_LINE_SIZE];
+
+	golden_format_trace(line, frame, p_frame_out);
+	if (m_trace_file != NULL) {
+		fprintf(m_trace_file, "%s\n", line);
+	}
+
+	if (m_reference_file == NULL || m_difference_found) {
+		return;
+	}
+
+	if (fgets(reference_line, sizeof(reference_line), m_reference_file) == NULL) {
+		printf("  reference trace ends before frame %u\n", frame);
+		m_difference_found = true;
+		return;
+	}
+	reference_line[strcspn(reference_line, "\n")] = '\0';
+
+	if (strcmp(line, reference_line) != 0) {
+		golden_report_trace_difference(line, reference_line);
+		m_difference_found = true;
+	}
+}
+
+/**
+ * @brief Render the note script for one patch, hashing the int32 output and the per-operator state in windows.
+ */
+static ret_code_t golden_render_patch(patch_file_rom_t rom, uint8_t patch, golden_window_t *p_windows) {
+	int32_t frame_out[2];
+	uint32_t event_idx = 0;
+
+	voice_params_t voice_params;
+	RET_ON_FAIL(patch_file_load_rom(&synth_data.patch_file, rom));
+	RET_ON_FAIL(patch_file_load_patch(&synth_data.patch_file, patch, &voice_params));
+	RET_ON_FAIL(synthesizer_set_patch(&synth_data, &voice_params));
+
+	// Start every patch from the same state, disabled voices keep their phase otherwise
+	memset(&synth_data.voice_data, 0, sizeof(synth_data.voice_data));
+	voice_init(&synth_data);
+
+	for (uint32_t window_idx = 0; window_idx < GOLDEN_NUM_WINDOWS; window_idx++) {
+		golden_window_t *p_window = &p_windows[window_idx];
+		p_window->output = FNV_OFFSET_BASIS;
+		for (uint32_t operator_idx = 0; operator_idx < NUM_OPERATORS; operator_idx++) {
+			p_window->operators[operator_idx] = FNV_OFFSET_BASIS;
+		}
+
+		for (uint32_t i = 0; i < GOLDEN_WINDOW_FRAMES; i++) {
+			uint32_t frame = window_idx * GOLDEN_WINDOW_FRAMES + i;
+			while (event_idx < sizeof(golden_script) / sizeof(golden_script[0]) && golden_script[event_idx].frame == frame) {
+				const golden_event_t *p_event = &golden_script[event_idx++];
+				synthesizer_queue_midi_event(&synth_data, p_event->status, p_event->key, p_event->velocity);
+			}
+
+			synthesizer_render_frames(&synth_data, frame_out, 1);
+			p_window->output = hash_word(p_window->output, (uint32_t) frame_out[0]);
+			p_window->output = hash_word(p_window->output, (uint32_t) frame_out[1]);
+
+			if (m_trace_file != NULL || m_reference_file != NULL) {
+				golden_trace_frame(frame, frame_out);
+			}
+
+			golden_hash_operators(p_window);
+		}
+	}
+
+	return RET_CODE_OK;
+}
+
+/**
+ * @brief Check that a chord queued in one batch does not steal its own voices under VOICE_STEAL_POLICY_QUIETEST.
+ * Every voice is held, then one key is released until its voice is free again, so the only free voice has stale
+ * silent operator levels; every chord note after the first has to steal a held voice instead of the note started
+ * just before it.
+ *
+ * @return true if every chord note is sounding
+ */
+static bool golden_check_chord_steal(void) {
+	static const uint8_t chord[] = {90, 91, 92};
+	voice_allocator_t *p_alloc = &synth_data.voice_allocator;
+	voice_steal_policy_t steal_policy = p_alloc->steal_policy;
+	int32_t frame_out[2];
+	bool passed = true;
+
+	voice_params_t voice_params;
+	if (patch_file_load_rom(&synth_data.patch_file, 0) != RET_CODE_OK ||
+		patch_file_load_patch(&synth_data.patch_file, GOLDEN_STEAL_PATCH, &voice_params) != RET_CODE_OK ||
+		synthesizer_set_patch(&synth_data, &voice_params) != RET_CODE_OK) {
+		log_error("Failed to load the chord steal patch")
+		return false;
+	}
+
+	memset(&synth_data.voice_data, 0, sizeof(synth_data.voice_data));
+	voice_init(&synth_data);
+	voice_set_steal_policy(&synth_data, VOICE_STEAL_POLICY_QUIETEST);
+
+	for (uint32_t i = 0; i < NUM_VOICES; i++) {
+		synthesizer_queue_midi_event(&synth_data, MIDI_STATUS_NOTE_ON, 40 + i % GOLDEN_STEAL_NUM_KEYS, 100);
+	}
+	synthesizer_render_frames(&synth_data, frame_out, 1);
+	synthesizer_queue_midi_event(&synth_data, MIDI_STATUS_NOTE_OFF, 40, 0);
+	synthesizer_render_frames(&synth_data, frame_out, 1);
+	// Render the release tail until the voice is free again
+	for (uint32_t frame = 0; frame < GOLDEN_STEAL_MAX_FRAMES && p_alloc->list_count[VOICE_LIST_RELEASED] > 0; frame++) {
+		synthesizer_render_frames(&synth_data, frame_out, 1);
+	}
+
+	for (uint32_t i = 0; i < sizeof(chord) / sizeof(chord[0]); i++) {
+		synthesizer_queue_midi_event(&synth_data, MIDI_STATUS_NOTE_ON, chord[i], 100);
+	}
+	synthesizer_render_frames(&synth_data, frame_out, 1);
+
+	for (uint32_t i = 0; i < sizeof(chord) / sizeof(chord[0]); i++) {
+		if (p_alloc->note_head[chord[i]] == VOICE_NONE) {
+			printf("FAILED: chord note %u was stolen by a later note of the same batch\n", chord[i]);
+			passed = false;
+		}
+	}
+
+	voice_set_steal_policy(&synth_data, steal_policy);
+	return passed;
+}
+
+static ret_code_t golden_write(const char *path) {
+	FILE *file = fopen(path, "w");
+	if (file == NULL) {
+		log_error("Failed to open %s for writing", path);
+		return RET_CODE_ERROR;
+	}
+
+	fprintf(file, "# Golden render hashes, regenerate with: golden_render --update\n");
+	fprintf(file, "# rom patch window output op1 op2 op3 op4 op5 op6\n");
+	for (uint32_t rom = 0; rom < PATCH_FILE_ROM_COUNT; rom++) {
+		for (uint32_t patch = 0; patch < PATCH_FILE_NUM_VOICES; patch++) {
+			for (uint32_t window_idx = 0; window_idx < GOLDEN_NUM_WINDOWS; window_idx++) {
+				golden_window_t *p_window = &m_rendered[rom][patch][window_idx];
+				fprintf(file, "%u %u %u %016" PRIx64, rom, patch + 1, window_idx, p_window->output);
+				for (uint32_t operator_idx = 0; operator_idx < NUM_OPERATORS; operator_idx++) {
+					fprintf(file, " %016" PRIx64, p_window->operators[operator_idx]);
+				}
+				fprintf(file, "\n");
+			}
+		}
+	}
+
+	fclose(file);
+	return RET_CODE_OK;
+}
+
+static ret_code_t golden_read(const char *path) {
+	FILE *file = fopen(path, "r");
+	if (file == NULL) {
+		log_error("Failed to open %s, create it with --update", path);
+		return RET_CODE_ERROR;
+	}
+
+	char line[512];
+	uint32_t num_entries = 0;
+	while (fgets(line, sizeof(line), file) != NULL) {
+		if (line[0] == '#' || line[0] == '\n') {
+			continue;
+		}
+
+		uint32_t rom, patch, window_idx;
+		golden_window_t window;
+		int num_fields = sscanf(line, "%u %u %u %" SCNx64 " %" SCNx64 " %" SCNx64 " %" SCNx64 " %" SCNx64 " %" SCNx64 " %" SCNx64,
+								&rom, &patch, &window_idx, &window.output,
+								&window.operators[0], &window.operators[1], &window.operators[2],
+								&window.operators[3], &window.operators[4], &window.operators[5]);
+		if (num_fields != 4 + NUM_OPERATORS || rom >= PATCH_FILE_ROM_COUNT || patch < 1 || patch > PATCH_FILE_NUM_VOICES ||
+			window_idx >= GOLDEN_NUM_WINDOWS) {
+			log_error("Malformed golden entry: %s", line);
+			fclose(file);
+			return RET_CODE_ERROR;
+		}
+
+		m_golden[rom][patch - 1][window_idx] = window;
+		num_entries++;
+	}
+
+	fclose(file);
+
+	if (num_entries != GOLDEN_NUM_PATCHES * GOLDEN_NUM_WINDOWS) {
+		log_error("Golden file has %u entries, expected %u", num_entries, GOLDEN_NUM_PATCHES * GOLDEN_NUM_WINDOWS);
+		return RET_CODE_ERROR;
+	}
+
+	return RET_CODE_OK;
+}
+
+/**
+ * @brief Render a mismatching patch again and compare it frame by frame with the trace of a reference build, to
+ * report the exact frame, voice and operator that differ first.
+ */
+static void golden_locate_difference(uint32_t rom, uint32_t patch) {
+	char path[512];
+	snprintf(path, sizeof(path), "%s/rom%u_patch%u.trace", m_reference_dir, rom, patch + 1);
+	m_reference_file = fopen(path, "r");
+	if (m_reference_file == NULL) {
+		printf("  no reference trace %s, write it with a reference build: golden_render --trace %u %u > %s\n",
+			   path, rom, patch + 1, path);
+		return;
+	}
+
+	m_difference_found = false;
+	if (golden_render_patch(rom, patch, m_rendered[rom][patch]) != RET_CODE_OK) {
+		log_error("Failed to render rom %u patch %u", rom, patch + 1);
+	} else if (!m_difference_found) {
+		printf("  no difference to the reference trace %s\n", path);
+	}
+
+	fclose(m_reference_file);
+	m_reference_file = NULL;
+}
+
+/**
+ * @brief Compare one patch against the golden hashes and report the first differing window and its operators.
+ * With --reference the exact frame, voice and operator are located as well.
+ *
+ * @return true if the patch matches
+ */
+static bool golden_compare_patch(uint32_t rom, uint32_t patch) {
+	for (uint32_t window_idx = 0; window_idx < GOLDEN_NUM_WINDOWS; window_idx++) {
+		golden_window_t *p_golden = &m_golden[rom][patch][window_idx];
+		golden_window_t *p_rendered = &m_rendered[rom][patch][window_idx];
+
+		bool output_differs = p_golden->output != p_rendered->output;
+		uint32_t differing_operators = 0;
+		for (uint32_t operator_idx = 0; operator_idx < NUM_OPERATORS; operator_idx++) {
+			if (p_golden->operators[operator_idx] != p_rendered->operators[operator_idx]) {
+				differing_operators |= 1 << operator_idx;
+			}
+		}
+
+		if (!output_differs && differing_operators == 0) {
+			continue;
+		}
+
+		printf("MISMATCH rom %u patch %u: first difference in frames %u..%u (%s)", rom, patch + 1,
+			   window_idx * GOLDEN_WINDOW_FRAMES, (window_idx + 1) * GOLDEN_WINDOW_FRAMES - 1,
+			   output_differs ? "output" : "operator state only");
+		if (differing_operators != 0) {
+			printf(", operators:");
+			for (uint32_t operator_idx = 0; operator_idx < NUM_OPERATORS; operator_idx++) {
+				if (differing_operators & (1 << operator_idx)) {
+					printf(" op%u", operator_idx + 1);
+				}
+			}
+		}
+		printf("\n");
+
+		if (m_reference_dir != NULL) {
+			golden_locate_difference(rom, patch);
+		}
+		return false;
+	}
+
+	return true;
+}
+
+static void print_usage(const char *program) {
+	fprintf(stderr, "Usage: %s [--update] [--reference <trace dir>] [golden file]\n", program);
+	fprintf(stderr, "       %s --trace <rom 0-%u> <patch 1-%u>\n", program, PATCH_FILE_ROM_COUNT - 1, PATCH_FILE_NUM_VOICES);
+	fprintf(stderr, "--reference compares mismatching patches frame by frame with <trace dir>/rom<rom>_patch<patch>.trace,\n"
+					"written by a reference build with --trace\n");
+}
+
+int main(int argc, char **argv) {
+	bool update = false;
+	const char *golden_path = GOLDEN_FILE_PATH;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--update") == 0) {
+			update = true;
+		} else if (strcmp(argv[i], "--trace") == 0 && i + 2 < argc) {
+			// Per-frame output and operator state of every audible voice, the reference for --reference
+			uint32_t rom = (uint32_t) atoi(argv[i + 1]);
+			uint32_t patch = (uint32_t) atoi(argv[i + 2]);
+			if (rom >= PATCH_FILE_ROM_COUNT || patch < 1 || patch > PATCH_FILE_NUM_VOICES ||
+				synthesizer_init(&synth_data, AUDIO_SAMPLE_RATE) != RET_CODE_OK) {
+				print_usage(argv[0]);
+				return 1;
+			}
+			m_trace_file = stdout;
+			return golden_render_patch(rom, patch - 1, m_rendered[rom][patch - 1]) == RET_CODE_OK ? 0 : 1;
+		} else if (strcmp(argv[i], "--reference") == 0 && i + 1 < argc) {
+			m_reference_dir = argv[++i];
+		} else if (argv[i][0] != '-') {
+			golden_path = argv[i];
+		} else {
+			print_usage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (ENVELOPE_BLOCK_SIZE != 1) {
+		log_warning("ENVELOPE_BLOCK_SIZE is %d, output is not expected to be bit-exact", ENVELOPE_BLOCK_SIZE);
+	}
+
+	if (synthesizer_init(&synth_data, AUDIO_SAMPLE_RATE) != RET_CODE_OK) {
+		log_error("Failed to initialize synthesizer.")
+		return 1;
+	}
+
+	if (!update && golden_read(golden_path) != RET_CODE_OK) {
+		return 1;
+	}
+
+	for (uint32_t rom = 0; rom < PATCH_FILE_ROM_COUNT; rom++) {
+		for (uint32_t patch = 0; patch < PATCH_FILE_NUM_VOICES; patch++) {
+			if (golden_render_patch(rom, patch, m_rendered[rom][patch]) != RET_CODE_OK) {
+				log_error("Failed to render rom %u patch %u", rom, patch + 1);
+				return 1;
+			}
+		}
+	}
+
+	if (update) {
+		if (golden_write(golden_path) != RET_CODE_OK) {
+			return 1;
+		}
+		printf("Wrote %u golden entries to %s\n", GOLDEN_NUM_PATCHES * GOLDEN_NUM_WINDOWS, golden_path);
+		return 0;
+	}
+
+	uint32_t num_mismatches = 0;
+	for (uint32_t rom = 0; rom < PATCH_FILE_ROM_COUNT; rom++) {
+		for (uint32_t patch = 0; patch < PATCH_FILE_NUM_VOICES; patch++) {
+			if (!golden_compare_patch(rom, patch)) {
+				num_mismatches++;
+			}
+		}
+	}
+
+	if (num_mismatches > 0) {
+		printf("FAILED: %u of %u patches differ from %s\n", num_mismatches, GOLDEN_NUM_PATCHES, golden_path);
+		return 1;
+	}
+
+	if (!golden_check_chord_steal()) {
+		return 1;
+	}
+
+	printf("OK: %u patches bit-identical to %s\n", GOLDEN_NUM_PATCHES, golden_path);
+	return 0;
+}
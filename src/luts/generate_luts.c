@@ -4,9 +4,11 @@
 
 #include "generate_luts.h"
 #include "config.h"
-#include <math.h>
+#include "lut_generators.h"
 #include <stdint.h>
 #include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
 
 #define BUFFER_SIZE			10 * 1024
 
@@ -60,53 +62,198 @@ static void write_hex_bytes_to_file(uint8_t *p_data, uint32_t num_elements, uint
 	fclose(file);
 }
 
-int main(void) {
-	// Note (MIDI) to log frequency table
-	uint32_t note_to_log_freq_base = (uint32_t) ((1 << SAMPLE_BIT_WIDTH) * (log(BASE_PITCH_FREQUENCY_HZ) / log(2) - (double) BASE_PITCH_MIDI_NOTE / HALF_TONES_PER_OCTAVE));
-	uint32_t note_to_log_freq_step = (1 << SAMPLE_BIT_WIDTH) / HALF_TONES_PER_OCTAVE;
-	for (uint32_t i = 0; i < NOTE_TO_LOG_FREQ_TABLE_SIZE; i++) {
-		buffer_32[i] = note_to_log_freq_base + note_to_log_freq_step * i;
+/**
+ * @brief Append a table as a static const C array to an open header, aligned for SIMD loads.
+ *
+ * @param file header, NULL to skip
+ * @param p_data little endian elements
+ * @param num_elements
+ * @param element_size 1, 2 or 4 bytes
+ * @param is_signed element type is intN_t instead of uintN_t
+ * @param name array name
+ */
+static void write_c_array_to_file(FILE *file, const uint8_t *p_data, uint32_t num_elements, uint32_t element_size, bool is_signed, const char *name) {
+	if (file == NULL) {
+		return;
 	}
-	write_hex_bytes_to_file(buffer_8, NOTE_TO_LOG_FREQ_TABLE_SIZE, sizeof(uint32_t), "hex_u32_note_to_log_freq.mem");
 
+	fprintf(file, "\nstatic const %sint%u_t %s[%u] __attribute__((aligned(64))) = {", is_signed ? "" : "u", element_size * 8, name, num_elements);
+	for (uint32_t i = 0; i < num_elements; i++) {
+		uint32_t value = 0;
+		for (uint32_t byte_idx = 0; byte_idx < element_size; byte_idx++) {
+			value |= (uint32_t) p_data[i * element_size + byte_idx] << (byte_idx * 8);
+		}
+
+		fprintf(file, i % 8 == 0 ? "\n\t\t" : " ");
+		if (is_signed) {
+			fprintf(file, "%d,", (int32_t) value);
+		} else {
+			fprintf(file, "0x%0*X,", element_size * 2, value);
+		}
+	}
+	fprintf(file, "\n};\n");
+}
+
+static void write_output_mask(FILE *file, uint8_t mask) {
+	if (mask == 0) {
+		fprintf(file, "0");
+		return;
+	}
+
+	bool first = true;
+	for (uint32_t output_idx = 0; output_idx < NUM_OPERATORS; output_idx++) {
+		if (mask & (1 << output_idx)) {
+			fprintf(file, first ? "OUTPUT_MODE_INDEX_%u" : " | OUTPUT_MODE_INDEX_%u", output_idx + 1);
+			first = false;
+		}
+	}
+}
+
+/**
+ * @brief Write one fully unrolled render kernel per algorithm routing table entry as a C header.
+ * Routes to operators that are already sampled in the current frame (including the self route of the
+ * feedback operator) never reach an operator and are dropped.
+ */
+static void write_algorithm_kernels(uint8_t routing_table[][NUM_OPERATORS], uint32_t num_algorithms, const char *filename) {
+	// build file path
+	char file_path[256];
+	sprintf(file_path, "%s/%s", LUT_GENERATE_DIR, filename);
 
-	// Log frequency to phase table
-	double log_freq_to_phase_base = (1LL << (SAMPLE_BIT_WIDTH + LOG_FREQ_TO_PHASE_TABLE_BIT_WIDTH)) / AUDIO_SAMPLE_RATE;
-	double log_freq_to_phase_mult = pow(2, 1.0 / LOG_FREQ_TO_PHASE_TABLE_SIZE);
-	for (uint32_t i = 0; i < LOG_FREQ_TO_PHASE_TABLE_SIZE + 1; i++) {
-		buffer_32[i] = (uint32_t) floor(log_freq_to_phase_base + 0.5);
-		log_freq_to_phase_base *= log_freq_to_phase_mult;
+	// open file
+	FILE *file = fopen(file_path, "w");
+	if (file == NULL) {
+		return;
 	}
+
+	// write comment header
+	fprintf(file, "// %s: %d render kernels and carrier masks, generated by generate_luts from the algorithm routing table\n", filename, num_algorithms);
+
+	// write kernels
+	for (uint32_t algorithm_idx = 0; algorithm_idx < num_algorithms; algorithm_idx++) {
+		const uint8_t *routing = routing_table[algorithm_idx];
+
+		fprintf(file, "\nstatic int32_t render_algorithm_%u(voice_data_t *p_voice_data, uint8_t feedback_shift, uint32_t voice_start, uint32_t voice_end) {\n", algorithm_idx);
+		fprintf(file, "\tint32_t master_buffer = 0;\n");
+
+		// Algorithms without a feedback operator do not use the feedback shift
+		bool has_feedback = false;
+		for (uint32_t operator_idx = 0; operator_idx < NUM_OPERATORS; operator_idx++) {
+			has_feedback |= (routing[operator_idx] & (1 << operator_idx)) != 0;
+		}
+		if (!has_feedback) {
+			fprintf(file, "\t(void) feedback_shift;\n");
+		}
+		fprintf(file, "\n");
+
+		for (uint32_t operator_idx = 0; operator_idx < NUM_OPERATORS; operator_idx++) {
+			if (routing[operator_idx] & (1 << operator_idx)) {
+				fprintf(file, "\toperator_feedback_input(p_voice_data, %u, feedback_shift, voice_start, voice_end);\n", operator_idx);
+			} else {
+				fprintf(file, "\toperator_clear_input(p_voice_data, %u, voice_start, voice_end);\n", operator_idx);
+			}
+		}
+		fprintf(file, "\n");
+
+		for (int32_t operator_idx = NUM_OPERATORS - 1; operator_idx >= 0; operator_idx--) {
+			bool carrier = routing[operator_idx] & OUTPUT_MOD_INDEX_MASTER;
+			bool feedback = routing[operator_idx] & (1 << operator_idx);
+			uint8_t mod_outputs = routing[operator_idx] & ((1 << operator_idx) - 1);
+
+			fprintf(file, carrier ? "\tmaster_buffer += " : "\t");
+			fprintf(file, "operator_sample_voices(p_voice_data, voice_start, voice_end, %d, ", operator_idx);
+			write_output_mask(file, mod_outputs);
+			fprintf(file, ", %s, %s);\n", carrier ? "true" : "false", feedback ? "true" : "false");
+		}
+
+		fprintf(file, "\n\treturn master_buffer;\n}\n");
+	}
+
+	// write kernel table
+	fprintf(file, "\nstatic const algorithm_kernel_t algorithm_kernels[%u] = {\n", num_algorithms);
+	for (uint32_t algorithm_idx = 0; algorithm_idx < num_algorithms; algorithm_idx++) {
+		fprintf(file, "\t\trender_algorithm_%u,\n", algorithm_idx);
+	}
+	fprintf(file, "};\n");
+
+	// write carrier masks, bit i set if operator i routes to the master output
+	fprintf(file, "\nstatic const uint8_t algorithm_carrier_masks[%u] = {\n", num_algorithms);
+	for (uint32_t algorithm_idx = 0; algorithm_idx < num_algorithms; algorithm_idx++) {
+		uint8_t carrier_mask = 0;
+		for (uint32_t operator_idx = 0; operator_idx < NUM_OPERATORS; operator_idx++) {
+			if (routing_table[algorithm_idx][operator_idx] & OUTPUT_MOD_INDEX_MASTER) {
+				carrier_mask |= 1 << operator_idx;
+			}
+		}
+		fprintf(file, "\t\t0x%02X,\n", carrier_mask);
+	}
+	fprintf(file, "};\n");
+
+	// close file
+	fclose(file);
+}
+
+/**
+ * @brief Generate the .mem tables for the Verilog flow and the render kernels. With --c-headers the tables are
+ * also written to lut_tables.h, which the engine compiles in when built with SYNTH_EMBED_LUTS.
+ */
+int main(int argc, char **argv) {
+	FILE *header_file = NULL;
+	if (argc > 1 && strcmp(argv[1], "--c-headers") == 0) {
+		char header_path[256];
+		sprintf(header_path, "%s/%s", LUT_GENERATE_DIR, "lut_tables.h");
+		header_file = fopen(header_path, "w");
+		if (header_file == NULL) {
+			log_error("Failed to open file %s.", header_path);
+			return 1;
+		}
+		fprintf(header_file, "// lut_tables.h: lookup tables compiled in with SYNTH_EMBED_LUTS, generated by generate_luts --c-headers\n");
+	}
+
+	// Note (MIDI) to log frequency table
+	lut_generate_note_to_log_freq(buffer_32);
+	write_hex_bytes_to_file(buffer_8, NOTE_TO_LOG_FREQ_TABLE_SIZE, sizeof(uint32_t), "hex_u32_note_to_log_freq.mem");
+	write_c_array_to_file(header_file, buffer_8, NOTE_TO_LOG_FREQ_TABLE_SIZE, sizeof(uint32_t), false, "note_to_log_freq_table");
+
+
+	// Log frequency to phase table, the engine computes its own for the sample rate it runs at
+	lut_generate_log_freq_to_phase(buffer_32, AUDIO_SAMPLE_RATE);
 	write_hex_bytes_to_file(buffer_8, LOG_FREQ_TO_PHASE_TABLE_SIZE + 1, sizeof(uint32_t), "hex_u32_log_freq_to_phase.mem");
 
 
 	// Log sine table (quarter period)
+	lut_generate_log_sin(buffer_16);
+	write_hex_bytes_to_file(buffer_8, LOG_SIN_TABLE_SIZE, sizeof(uint16_t), "hex_u16_log_sin.mem");
+	write_c_array_to_file(header_file, buffer_8, LOG_SIN_TABLE_SIZE, sizeof(uint16_t), false, "log_sin_table");
+	// 32 bit copy for gathers
+	uint32_t log_sin_table_32[LOG_SIN_TABLE_SIZE];
 	for (uint32_t i = 0; i < LOG_SIN_TABLE_SIZE; i++) {
-		buffer_16[i] = (uint16_t) round(-(1 << LOG_SIN_TABLE_BIT_WIDTH) * log(sin((i + 0.5) / LOG_SIN_TABLE_SIZE * M_PI_2)) / log(2));
+		log_sin_table_32[i] = buffer_16[i];
 	}
-	write_hex_bytes_to_file(buffer_8, LOG_SIN_TABLE_SIZE, sizeof(uint16_t), "hex_u16_log_sin.mem");
+	write_c_array_to_file(header_file, (uint8_t *) log_sin_table_32, LOG_SIN_TABLE_SIZE, sizeof(uint32_t), false, "log_sin_table_32");
 
 
 	// Exp table
+	lut_generate_exp(buffer_16);
+	write_hex_bytes_to_file(buffer_8, EXP_TABLE_SIZE, sizeof(uint16_t), "hex_u16_exp.mem");
+	write_c_array_to_file(header_file, buffer_8, EXP_TABLE_SIZE, sizeof(uint16_t), false, "exp_table");
+	// 32 bit copy for gathers
+	uint32_t exp_table_32[EXP_TABLE_SIZE];
 	for (uint32_t i = 0; i < EXP_TABLE_SIZE; i++) {
-		buffer_16[i] = (uint16_t) round((1 << EXP_TABLE_BIT_WIDTH) * (pow(2, (double) i / EXP_TABLE_SIZE) - 1));
+		exp_table_32[i] = buffer_16[i];
 	}
-	write_hex_bytes_to_file(buffer_8, EXP_TABLE_SIZE, sizeof(uint16_t), "hex_u16_exp.mem");
+	write_c_array_to_file(header_file, (uint8_t *) exp_table_32, EXP_TABLE_SIZE, sizeof(uint32_t), false, "exp_table_32");
 
 
 	// Coarse log multiplier table
-	for (uint32_t i = 0; i < COARSE_LOG_MULT_TABLE_SIZE; i++) {
-		double x = i == 0 ? 0.5 : i;
-		buffer_32[i] = (int32_t) ((1 << COARSE_LOG_MULT_TABLE_BIT_WIDTH) * (log(x) / log(2)));
-	}
+	lut_generate_coarse_log_mult((int32_t *) buffer_32);
 	write_hex_bytes_to_file(buffer_8, COARSE_LOG_MULT_TABLE_SIZE, sizeof(uint32_t), "hex_i32_coarse_log_mult.mem");
+	write_c_array_to_file(header_file, buffer_8, COARSE_LOG_MULT_TABLE_SIZE, sizeof(int32_t), true, "coarse_log_mult_table");
 
 
 	// Fine log multiplier table (like coarse but 1/100th)
-	for (uint32_t i = 0; i < FINE_LOG_MULT_TABLE_SIZE; i++) {
-		buffer_32[i] = (uint32_t) ((1 << FINE_LOG_MULT_TABLE_BIT_WIDTH) * (log(1 + (double) i / 100) / log(2)));
-	}
+	lut_generate_fine_log_mult(buffer_32);
 	write_hex_bytes_to_file(buffer_8, FINE_LOG_MULT_TABLE_SIZE, sizeof(uint32_t), "hex_u32_fine_log_mult.mem");
+	write_c_array_to_file(header_file, buffer_8, FINE_LOG_MULT_TABLE_SIZE, sizeof(uint32_t), false, "fine_log_mult_table");
 
 
 	// Algorithm routing table
@@ -150,6 +297,7 @@ int main(void) {
 		buffer_64[i] = algorithm & 0xFFFFFFFFFFFF;
 	}
 	write_hex_bytes_to_file(buffer_8, ALGORITHM_ROUTING_TABLE_SIZE, 8, "hex_u64_algorithm_routing.mem");
+	write_algorithm_kernels(algorithm_routing_table, ALGORITHM_ROUTING_TABLE_SIZE, "algorithm_kernels.h");
 
 
 	// Level scale table
@@ -161,8 +309,13 @@ int main(void) {
 												   111, 112, 113, 114, 115, 116, 117, 118, 119, 120, 121, 122, 123, 124,
 												   125, 126, 127};
 	write_hex_bytes_to_file(level_scale, LEVEL_SCALE_TABLE_SIZE, 1, "hex_u8_level_scale.mem");
+	write_c_array_to_file(header_file, level_scale, LEVEL_SCALE_TABLE_SIZE, 1, false, "level_scale_table");
 
 
 	// Level decibel amplitude table
 
+	if (header_file != NULL) {
+		fclose(header_file);
+	}
+	return 0;
 }
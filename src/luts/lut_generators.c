@@ -0,0 +1,82 @@
+//
+// Created by Tim Holzhey on 17.10.26
+//
+
+#include <math.h>
+#include "lut_generators.h"
+
+// Table generators shared by generate_luts (.mem files for the Verilog flow) and the engine, which computes the
+// sample rate dependent tables at startup
+
+/**
+ * @brief Note (MIDI) to log frequency table.
+ *
+ * @param p_table NOTE_TO_LOG_FREQ_TABLE_SIZE elements
+ */
+void lut_generate_note_to_log_freq(uint32_t *p_table) {
+	uint32_t note_to_log_freq_base = (uint32_t) ((1 << SAMPLE_BIT_WIDTH) * (log(BASE_PITCH_FREQUENCY_HZ) / log(2) - (double) BASE_PITCH_MIDI_NOTE / HALF_TONES_PER_OCTAVE));
+	uint32_t note_to_log_freq_step = (1 << SAMPLE_BIT_WIDTH) / HALF_TONES_PER_OCTAVE;
+	for (uint32_t i = 0; i < NOTE_TO_LOG_FREQ_TABLE_SIZE; i++) {
+		p_table[i] = note_to_log_freq_base + note_to_log_freq_step * i;
+	}
+}
+
+/**
+ * @brief Log frequency to phase increment table, one octave.
+ *
+ * @param p_table LOG_FREQ_TO_PHASE_TABLE_SIZE + 1 elements
+ * @param sample_rate Hz
+ */
+void lut_generate_log_freq_to_phase(uint32_t *p_table, uint32_t sample_rate) {
+	double log_freq_to_phase_base = (1LL << (SAMPLE_BIT_WIDTH + LOG_FREQ_TO_PHASE_TABLE_BIT_WIDTH)) / sample_rate;
+	double log_freq_to_phase_mult = pow(2, 1.0 / LOG_FREQ_TO_PHASE_TABLE_SIZE);
+	for (uint32_t i = 0; i < LOG_FREQ_TO_PHASE_TABLE_SIZE + 1; i++) {
+		p_table[i] = (uint32_t) floor(log_freq_to_phase_base + 0.5);
+		log_freq_to_phase_base *= log_freq_to_phase_mult;
+	}
+}
+
+/**
+ * @brief Log sine table (quarter period).
+ *
+ * @param p_table LOG_SIN_TABLE_SIZE elements
+ */
+void lut_generate_log_sin(uint16_t *p_table) {
+	for (uint32_t i = 0; i < LOG_SIN_TABLE_SIZE; i++) {
+		p_table[i] = (uint16_t) round(-(1 << LOG_SIN_TABLE_BIT_WIDTH) * log(sin((i + 0.5) / LOG_SIN_TABLE_SIZE * M_PI_2)) / log(2));
+	}
+}
+
+/**
+ * @brief Exp table.
+ *
+ * @param p_table EXP_TABLE_SIZE elements
+ */
+void lut_generate_exp(uint16_t *p_table) {
+	for (uint32_t i = 0; i < EXP_TABLE_SIZE; i++) {
+		p_table[i] = (uint16_t) round((1 << EXP_TABLE_BIT_WIDTH) * (pow(2, (double) i / EXP_TABLE_SIZE) - 1));
+	}
+}
+
+/**
+ * @brief Coarse log multiplier table.
+ *
+ * @param p_table COARSE_LOG_MULT_TABLE_SIZE elements
+ */
+void lut_generate_coarse_log_mult(int32_t *p_table) {
+	for (uint32_t i = 0; i < COARSE_LOG_MULT_TABLE_SIZE; i++) {
+		double x = i == 0 ? 0.5 : i;
+		p_table[i] = (int32_t) ((1 << COARSE_LOG_MULT_TABLE_BIT_WIDTH) * (log(x) / log(2)));
+	}
+}
+
+/**
+ * @brief Fine log multiplier table (like coarse but 1/100th).
+ *
+ * @param p_table FINE_LOG_MULT_TABLE_SIZE elements
+ */
+void lut_generate_fine_log_mult(uint32_t *p_table) {
+	for (uint32_t i = 0; i < FINE_LOG_MULT_TABLE_SIZE; i++) {
+		p_table[i] = (uint32_t) ((1 << FINE_LOG_MULT_TABLE_BIT_WIDTH) * (log(1 + (double) i / 100) / log(2)));
+	}
+}
@@ -0,0 +1,23 @@
+//
+// Created by Tim Holzhey on 17.10.26
+//
+
+#ifndef FM_SYNTHESIZER_LUT_GENERATORS_H
+#define FM_SYNTHESIZER_LUT_GENERATORS_H
+
+#include <stdint.h>
+#include "config.h"
+
+void lut_generate_note_to_log_freq(uint32_t *p_table);
+
+void lut_generate_log_freq_to_phase(uint32_t *p_table, uint32_t sample_rate);
+
+void lut_generate_log_sin(uint16_t *p_table);
+
+void lut_generate_exp(uint16_t *p_table);
+
+void lut_generate_coarse_log_mult(int32_t *p_table);
+
+void lut_generate_fine_log_mult(uint32_t *p_table);
+
+#endif //FM_SYNTHESIZER_LUT_GENERATORS_H
@@ -112,6 +112,7 @@ ret_code_t read_lut(const char *filename, uint8_t *p_data, uint32_t num_elements
 
 	// close file
 	fclose(file);
+	free(buffer);
 
 	return RET_CODE_OK;
 }
@@ -4,27 +4,68 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
 #include "common.h"
 #include "synthesizer.h"
 #include "audio_driver.h"
 #include "web_server.h"
+#include "visualization.h"
+
+static synth_data_t synth_data;
+static visualization_t visualization;
+static pthread_t control_thread;
+static atomic_bool control_running;
+
+/**
+ * @brief Control thread: logs the voice limit changes of the polyphony governor while the engine runs, whether or
+ * not a client polls the web server.
+ */
+static void *control_thread_main(void *p_arg) {
+	(void) p_arg;
+	while (atomic_load(&control_running)) {
+		synthesizer_log_governor_events(&synth_data);
+		usleep(VOICE_GOVERNOR_LOG_INTERVAL_MS * 1000);
+	}
+	synthesizer_log_governor_events(&synth_data);
+	return NULL;
+}
 
 int main(void) {
-	if (synthesizer_init() != RET_CODE_OK) {
+	uint32_t sample_rate;
+	if (audio_driver_init(&sample_rate) != RET_CODE_OK) {
+		log_error("Failed to initialize audio driver.")
+		return 1;
+	}
+
+	if (synthesizer_init(&synth_data, sample_rate) != RET_CODE_OK) {
 		log_error("Failed to initialize synthesizer.")
 		return 1;
 	}
 
-	if (audio_driver_start() != RET_CODE_OK) {
-		log_error("Failed to initialize audio driver.")
+	visualization_init(&visualization, sample_rate);
+	synth_data.p_visualization = &visualization;
+
+	if (audio_driver_start(&synth_data) != RET_CODE_OK) {
+		log_error("Failed to start audio driver.")
 		return 1;
 	}
 
-	if (web_server_start() != RET_CODE_OK) {
+	atomic_store(&control_running, true);
+	if (pthread_create(&control_thread, NULL, control_thread_main, NULL) != 0) {
+		log_error("Failed to start control thread.")
+		return 1;
+	}
+
+	if (web_server_start(&synth_data) != RET_CODE_OK) {
 		log_error("Failed to start web server.")
 		return 1;
 	}
 
+	atomic_store(&control_running, false);
+	pthread_join(control_thread, NULL);
+
 	if (audio_driver_stop() != RET_CODE_OK) {
 		log_error("Failed to stop audio driver.")
 		return 1;
@@ -0,0 +1,299 @@
+//
+// Created by Tim Holzhey on 17.10.26
+//
+
+#include <stdlib.h>
+#include "midi_file.h"
+
+#define MIDI_FILE_DEFAULT_TEMPO_US		500000
+#define MIDI_FILE_META_EVENT			0xFF
+#define MIDI_FILE_META_TEMPO			0x51
+#define MIDI_FILE_SYSEX_EVENT			0xF0
+#define MIDI_FILE_SYSEX_ESCAPE			0xF7
+
+typedef struct {
+	uint64_t tick;
+	uint32_t order;
+	uint32_t tempo_us;
+	uint8_t status;
+	uint8_t data1;
+	uint8_t data2;
+} midi_file_raw_event_t;
+
+typedef struct {
+	midi_file_raw_event_t *p_events;
+	uint32_t num_events;
+	uint32_t capacity;
+} midi_file_raw_events_t;
+
+static uint32_t read_u32_be(const uint8_t *p_data) {
+	return ((uint32_t) p_data[0] << 24) | ((uint32_t) p_data[1] << 16) | ((uint32_t) p_data[2] << 8) | p_data[3];
+}
+
+static uint16_t read_u16_be(const uint8_t *p_data) {
+	return ((uint16_t) p_data[0] << 8) | p_data[1];
+}
+
+static ret_code_t read_variable_length(const uint8_t *p_data, uint32_t data_len, uint32_t *p_index, uint32_t *p_value) {
+	uint32_t value = 0;
+	for (uint8_t i = 0; i < 4; i++) {
+		if (*p_index >= data_len) {
+			return RET_CODE_ERROR;
+		}
+		uint8_t byte = p_data[(*p_index)++];
+		value = (value << 7) | (byte & 0x7F);
+		if ((byte & 0x80) == 0) {
+			*p_value = value;
+			return RET_CODE_OK;
+		}
+	}
+	return RET_CODE_ERROR;
+}
+
+static ret_code_t raw_events_append(midi_file_raw_events_t *p_raw_events, const midi_file_raw_event_t *p_event) {
+	if (p_raw_events->num_events == p_raw_events->capacity) {
+		uint32_t capacity = p_raw_events->capacity ? p_raw_events->capacity * 2 : 1024;
+		midi_file_raw_event_t *p_events = realloc(p_raw_events->p_events, capacity * sizeof(midi_file_raw_event_t));
+		if (p_events == NULL) {
+			log_error("Failed to allocate memory");
+			return RET_CODE_ERROR;
+		}
+		p_raw_events->p_events = p_events;
+		p_raw_events->capacity = capacity;
+	}
+
+	p_raw_events->p_events[p_raw_events->num_events] = *p_event;
+	p_raw_events->p_events[p_raw_events->num_events].order = p_raw_events->num_events;
+	p_raw_events->num_events++;
+
+	return RET_CODE_OK;
+}
+
+static int raw_event_compare(const void *p_a, const void *p_b) {
+	const midi_file_raw_event_t *p_event_a = p_a;
+	const midi_file_raw_event_t *p_event_b = p_b;
+
+	if (p_event_a->tick != p_event_b->tick) {
+		return p_event_a->tick < p_event_b->tick ? -1 : 1;
+	}
+	return p_event_a->order < p_event_b->order ? -1 : 1;
+}
+
+/**
+ * @brief Parse one MTrk chunk, keeping note on/off and tempo events.
+ */
+static ret_code_t midi_file_parse_track(const uint8_t *p_data, uint32_t data_len, midi_file_raw_events_t *p_raw_events) {
+	uint32_t index = 0;
+	uint64_t tick = 0;
+	uint8_t running_status = 0;
+
+	while (index < data_len) {
+		uint32_t delta = 0;
+		if (read_variable_length(p_data, data_len, &index, &delta) != RET_CODE_OK || index >= data_len) {
+			log_error("Truncated MIDI track");
+			return RET_CODE_ERROR;
+		}
+		tick += delta;
+
+		uint8_t status = p_data[index];
+		if (status & 0x80) {
+			index++;
+		} else if (running_status != 0) {
+			status = running_status;
+		} else {
+			log_error("MIDI data byte without status");
+			return RET_CODE_ERROR;
+		}
+
+		if (status == MIDI_FILE_META_EVENT) {
+			if (index >= data_len) {
+				log_error("Truncated MIDI meta event");
+				return RET_CODE_ERROR;
+			}
+			uint8_t meta_type = p_data[index++];
+			uint32_t length = 0;
+			if (read_variable_length(p_data, data_len, &index, &length) != RET_CODE_OK || length > data_len - index) {
+				log_error("Truncated MIDI meta event");
+				return RET_CODE_ERROR;
+			}
+			if (meta_type == MIDI_FILE_META_TEMPO && length == 3) {
+				midi_file_raw_event_t event = {
+						.tick = tick,
+						.tempo_us = ((uint32_t) p_data[index] << 16) | ((uint32_t) p_data[index + 1] << 8) | p_data[index + 2],
+				};
+				RET_ON_FAIL(raw_events_append(p_raw_events, &event));
+			}
+			index += length;
+			continue;
+		}
+
+		if (status == MIDI_FILE_SYSEX_EVENT || status == MIDI_FILE_SYSEX_ESCAPE) {
+			uint32_t length = 0;
+			if (read_variable_length(p_data, data_len, &index, &length) != RET_CODE_OK || length > data_len - index) {
+				log_error("Truncated MIDI SysEx event");
+				return RET_CODE_ERROR;
+			}
+			index += length;
+			continue;
+		}
+
+		// Channel message: program change and channel pressure have one data byte
+		running_status = status;
+		uint8_t num_data_bytes = ((status & 0xF0) == 0xC0 || (status & 0xF0) == 0xD0) ? 1 : 2;
+		if (num_data_bytes > data_len - index) {
+			log_error("Truncated MIDI channel event");
+			return RET_CODE_ERROR;
+		}
+
+		uint8_t type = status & 0xF0;
+		if (type == 0x80 || type == 0x90) {
+			midi_file_raw_event_t event = {
+					.tick = tick,
+					.status = status,
+					.data1 = p_data[index],
+					.data2 = p_data[index + 1],
+			};
+			RET_ON_FAIL(raw_events_append(p_raw_events, &event));
+		}
+		index += num_data_bytes;
+	}
+
+	return RET_CODE_OK;
+}
+
+/**
+ * @brief Convert the merged events of all tracks from ticks to frames using the tempo map.
+ */
+static ret_code_t midi_file_convert_events(midi_file_raw_events_t *p_raw_events, uint16_t division, uint32_t sample_rate, midi_file_t *p_midi_file) {
+	qsort(p_raw_events->p_events, p_raw_events->num_events, sizeof(midi_file_raw_event_t), raw_event_compare);
+
+	p_midi_file->p_events = malloc((p_raw_events->num_events + 1) * sizeof(midi_file_event_t));
+	if (p_midi_file->p_events == NULL) {
+		log_error("Failed to allocate memory");
+		return RET_CODE_ERROR;
+	}
+	p_midi_file->num_events = 0;
+
+	uint64_t tempo_us = MIDI_FILE_DEFAULT_TEMPO_US;
+	uint64_t base_tick = 0;
+	uint64_t base_frame = 0;
+
+	for (uint32_t i = 0; i < p_raw_events->num_events; i++) {
+		midi_file_raw_event_t *p_raw_event = &p_raw_events->p_events[i];
+		uint64_t ticks = p_raw_event->tick - base_tick;
+		uint64_t frame;
+
+		if (division & 0x8000) {
+			// SMPTE: -frames per second in the high byte, ticks per frame in the low byte
+			uint64_t ticks_per_second = (uint64_t) (-(int8_t) (division >> 8)) * (division & 0xFF);
+			frame = p_raw_event->tick * sample_rate / ticks_per_second;
+		} else {
+			frame = base_frame + ticks * tempo_us * sample_rate / ((uint64_t) division * 1000000);
+		}
+
+		if (p_raw_event->tempo_us != 0) {
+			base_tick = p_raw_event->tick;
+			base_frame = frame;
+			tempo_us = p_raw_event->tempo_us;
+			continue;
+		}
+
+		p_midi_file->p_events[p_midi_file->num_events++] = (midi_file_event_t) {
+				.frame = frame,
+				.status = p_raw_event->status,
+				.data1 = p_raw_event->data1,
+				.data2 = p_raw_event->data2,
+		};
+	}
+
+	return RET_CODE_OK;
+}
+
+/**
+ * @brief Load the note on/off events of a Standard MIDI File (format 0 or 1), merged over all tracks and channels.
+ *
+ * @param file_path
+ * @param sample_rate used to convert event times to frames
+ * @param p_midi_file output, free with midi_file_free()
+ * @return
+ */
+ret_code_t midi_file_load(const char *file_path, uint32_t sample_rate, midi_file_t *p_midi_file) {
+	// Open file
+	FILE *file = fopen(file_path, "rb");
+	if (file == NULL) {
+		log_error("Failed to open file: %s", file_path);
+		return RET_CODE_ERROR;
+	}
+
+	// Read file into buffer
+	fseek(file, 0, SEEK_END);
+	long file_size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	uint8_t *buffer = malloc(file_size);
+	if (buffer == NULL) {
+		log_error("Failed to allocate memory");
+		fclose(file);
+		return RET_CODE_ERROR;
+	}
+	if (fread(buffer, 1, file_size, file) != (size_t) file_size) {
+		log_error("Failed to read file: %s", file_path);
+		fclose(file);
+		free(buffer);
+		return RET_CODE_ERROR;
+	}
+	fclose(file);
+
+	// Parse header
+	if (file_size < 14 || memcmp(buffer, "MThd", 4) != 0 || read_u32_be(&buffer[4]) < 6) {
+		log_error("Not a Standard MIDI File: %s", file_path);
+		free(buffer);
+		return RET_CODE_ERROR;
+	}
+	uint16_t num_tracks = read_u16_be(&buffer[10]);
+	uint16_t division = read_u16_be(&buffer[12]);
+	if (division == 0) {
+		log_error("Invalid MIDI time division");
+		free(buffer);
+		return RET_CODE_ERROR;
+	}
+
+	// Parse tracks
+	midi_file_raw_events_t raw_events = {0};
+	ret_code_t ret = RET_CODE_OK;
+	uint32_t index = 8 + read_u32_be(&buffer[4]);
+	uint16_t track_idx = 0;
+	while (track_idx < num_tracks && ret == RET_CODE_OK) {
+		if (file_size - index < 8) {
+			log_error("Truncated MIDI file");
+			ret = RET_CODE_ERROR;
+			break;
+		}
+		uint32_t chunk_len = read_u32_be(&buffer[index + 4]);
+		if (chunk_len > file_size - index - 8) {
+			log_error("Truncated MIDI chunk");
+			ret = RET_CODE_ERROR;
+			break;
+		}
+		// Unknown chunks are skipped
+		if (memcmp(&buffer[index], "MTrk", 4) == 0) {
+			ret = midi_file_parse_track(&buffer[index + 8], chunk_len, &raw_events);
+			track_idx++;
+		}
+		index += 8 + chunk_len;
+	}
+
+	if (ret == RET_CODE_OK) {
+		ret = midi_file_convert_events(&raw_events, division, sample_rate, p_midi_file);
+	}
+
+	free(raw_events.p_events);
+	free(buffer);
+
+	return ret;
+}
+
+void midi_file_free(midi_file_t *p_midi_file) {
+	free(p_midi_file->p_events);
+	p_midi_file->p_events = NULL;
+	p_midi_file->num_events = 0;
+}
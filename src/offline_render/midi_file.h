@@ -0,0 +1,27 @@
+//
+// Created by Tim Holzhey on 17.10.26
+//
+
+#ifndef FM_SYNTHESIZER_MIDI_FILE_H
+#define FM_SYNTHESIZER_MIDI_FILE_H
+
+#include "common.h"
+#include <stdint.h>
+
+typedef struct {
+	uint64_t frame;
+	uint8_t status;
+	uint8_t data1;
+	uint8_t data2;
+} midi_file_event_t;
+
+typedef struct {
+	midi_file_event_t *p_events;
+	uint32_t num_events;
+} midi_file_t;
+
+ret_code_t midi_file_load(const char *file_path, uint32_t sample_rate, midi_file_t *p_midi_file);
+
+void midi_file_free(midi_file_t *p_midi_file);
+
+#endif //FM_SYNTHESIZER_MIDI_FILE_H
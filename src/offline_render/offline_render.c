@@ -0,0 +1,128 @@
+//
+// Created by Tim Holzhey on 17.10.26
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "common.h"
+#include "synthesizer.h"
+#include "patch_file.h"
+#include "midi_file.h"
+#include "wav_file.h"
+
+#define OFFLINE_RENDER_DEFAULT_TAIL_SECONDS		2.0
+#define OFFLINE_RENDER_BITS_PER_SAMPLE			16
+
+static synth_data_t synth_data;
+
+static double get_time_seconds(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double) now.tv_sec + (double) now.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Render frames in blocks of AUDIO_FRAMES_PER_BUFFER and append them to the WAV file.
+ */
+static ret_code_t render_frames_to_file(wav_file_t *p_wav_file, uint64_t num_frames) {
+	int32_t buffer[AUDIO_FRAMES_PER_BUFFER * 2];
+
+	while (num_frames > 0) {
+		uint32_t block_frames = num_frames < AUDIO_FRAMES_PER_BUFFER ? (uint32_t) num_frames : AUDIO_FRAMES_PER_BUFFER;
+		synthesizer_render_frames(&synth_data, buffer, block_frames);
+		RET_ON_FAIL(wav_file_write(p_wav_file, buffer, block_frames));
+		num_frames -= block_frames;
+	}
+
+	return RET_CODE_OK;
+}
+
+static void print_usage(const char *program) {
+	fprintf(stderr, "Usage: %s <bank.syx> <voice 1-%u> <song.mid> <out.wav> [tail seconds] [sample rate]\n", program, PATCH_FILE_NUM_VOICES);
+}
+
+int main(int argc, char **argv) {
+	if (argc < 5 || argc > 7) {
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	const char *bank_path = argv[1];
+	int voice_number = atoi(argv[2]);
+	const char *midi_path = argv[3];
+	const char *wav_path = argv[4];
+	double tail_seconds = argc > 5 ? atof(argv[5]) : OFFLINE_RENDER_DEFAULT_TAIL_SECONDS;
+	uint32_t sample_rate = argc > 6 ? (uint32_t) atoi(argv[6]) : AUDIO_SAMPLE_RATE;
+
+	if (voice_number < 1 || voice_number > PATCH_FILE_NUM_VOICES || tail_seconds < 0) {
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	if (synthesizer_init(&synth_data, sample_rate) != RET_CODE_OK) {
+		log_error("Failed to initialize synthesizer.")
+		return 1;
+	}
+
+	voice_params_t voice_params;
+	if (patch_file_load_path(&synth_data.patch_file, bank_path) != RET_CODE_OK ||
+		patch_file_load_patch(&synth_data.patch_file, voice_number - 1, &voice_params) != RET_CODE_OK ||
+		synthesizer_set_patch(&synth_data, &voice_params) != RET_CODE_OK) {
+		log_error("Failed to load voice %d of %s.", voice_number, bank_path)
+		return 1;
+	}
+
+	midi_file_t midi_file;
+	if (midi_file_load(midi_path, sample_rate, &midi_file) != RET_CODE_OK) {
+		log_error("Failed to load MIDI file %s.", midi_path)
+		return 1;
+	}
+
+	wav_file_t wav_file;
+	if (wav_file_open(&wav_file, wav_path, sample_rate, 2, OFFLINE_RENDER_BITS_PER_SAMPLE) != RET_CODE_OK) {
+		midi_file_free(&midi_file);
+		return 1;
+	}
+
+	double start_time = get_time_seconds();
+	ret_code_t ret = RET_CODE_OK;
+	uint64_t frame = 0;
+
+	// Render up to each event, the event is applied on the first frame of the next render call
+	for (uint32_t event_idx = 0; event_idx < midi_file.num_events && ret == RET_CODE_OK; event_idx++) {
+		midi_file_event_t *p_event = &midi_file.p_events[event_idx];
+		ret = render_frames_to_file(&wav_file, p_event->frame - frame);
+		frame = p_event->frame;
+
+		if (synthesizer_queue_midi_event(&synth_data, p_event->status, p_event->data1, p_event->data2) != RET_CODE_OK) {
+			// Queue full: apply the queued events without advancing time and retry
+			synthesizer_render_frames(&synth_data, NULL, 0);
+			synthesizer_queue_midi_event(&synth_data, p_event->status, p_event->data1, p_event->data2);
+		}
+	}
+
+	// Render release tail
+	uint64_t tail_frames = (uint64_t) (tail_seconds * sample_rate);
+	if (ret == RET_CODE_OK) {
+		ret = render_frames_to_file(&wav_file, tail_frames);
+	}
+
+	double render_seconds = get_time_seconds() - start_time;
+
+	if (wav_file_close(&wav_file) != RET_CODE_OK) {
+		ret = RET_CODE_ERROR;
+	}
+	midi_file_free(&midi_file);
+
+	if (ret != RET_CODE_OK) {
+		log_error("Failed to render %s.", wav_path)
+		return 1;
+	}
+
+	double audio_seconds = (double) (frame + tail_frames) / sample_rate;
+	printf("Rendered %.2f s of audio in %.3f s (realtime factor %.1fx)\n", audio_seconds, render_seconds,
+		   render_seconds > 0 ? audio_seconds / render_seconds : 0.0);
+
+	return 0;
+}
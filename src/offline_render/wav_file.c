@@ -0,0 +1,143 @@
+//
+// Created by Tim Holzhey on 17.10.26
+//
+
+#include "wav_file.h"
+
+#define WAV_HEADER_SIZE			44
+#define WAV_FORMAT_PCM			1
+
+static void write_u32_le(uint8_t *p_data, uint32_t value) {
+	p_data[0] = value & 0xFF;
+	p_data[1] = (value >> 8) & 0xFF;
+	p_data[2] = (value >> 16) & 0xFF;
+	p_data[3] = (value >> 24) & 0xFF;
+}
+
+static void write_u16_le(uint8_t *p_data, uint16_t value) {
+	p_data[0] = value & 0xFF;
+	p_data[1] = (value >> 8) & 0xFF;
+}
+
+static ret_code_t wav_file_write_header(wav_file_t *p_wav_file) {
+	if (p_wav_file->raw) {
+		return RET_CODE_OK;
+	}
+
+	uint32_t block_align = p_wav_file->num_channels * p_wav_file->bits_per_sample / 8;
+	uint32_t data_size = p_wav_file->num_frames * block_align;
+	uint8_t header[WAV_HEADER_SIZE];
+
+	memcpy(&header[0], "RIFF", 4);
+	write_u32_le(&header[4], WAV_HEADER_SIZE - 8 + data_size);
+	memcpy(&header[8], "WAVE", 4);
+	memcpy(&header[12], "fmt ", 4);
+	write_u32_le(&header[16], 16);
+	write_u16_le(&header[20], WAV_FORMAT_PCM);
+	write_u16_le(&header[22], p_wav_file->num_channels);
+	write_u32_le(&header[24], p_wav_file->sample_rate);
+	write_u32_le(&header[28], p_wav_file->sample_rate * block_align);
+	write_u16_le(&header[32], block_align);
+	write_u16_le(&header[34], p_wav_file->bits_per_sample);
+	memcpy(&header[36], "data", 4);
+	write_u32_le(&header[40], data_size);
+
+	if (fseek(p_wav_file->file, 0, SEEK_SET) != 0 || fwrite(header, 1, sizeof(header), p_wav_file->file) != sizeof(header)) {
+		log_error("Failed to write WAV header");
+		return RET_CODE_ERROR;
+	}
+
+	return RET_CODE_OK;
+}
+
+static ret_code_t wav_file_create(wav_file_t *p_wav_file, const char *file_path, uint32_t sample_rate, uint16_t num_channels, uint16_t bits_per_sample, bool raw) {
+	if (bits_per_sample != 16 && bits_per_sample != 32) {
+		log_error("Unsupported WAV bit depth: %u", bits_per_sample);
+		return RET_CODE_ERROR;
+	}
+
+	p_wav_file->file = fopen(file_path, "wb");
+	if (p_wav_file->file == NULL) {
+		log_error("Failed to open file: %s", file_path);
+		return RET_CODE_ERROR;
+	}
+
+	p_wav_file->sample_rate = sample_rate;
+	p_wav_file->num_channels = num_channels;
+	p_wav_file->bits_per_sample = bits_per_sample;
+	p_wav_file->num_frames = 0;
+	p_wav_file->raw = raw;
+
+	return wav_file_write_header(p_wav_file);
+}
+
+/**
+ * @brief Create a PCM WAV file. The header is completed by wav_file_close().
+ *
+ * @param p_wav_file
+ * @param file_path
+ * @param sample_rate
+ * @param num_channels
+ * @param bits_per_sample 16 or 32
+ * @return
+ */
+ret_code_t wav_file_open(wav_file_t *p_wav_file, const char *file_path, uint32_t sample_rate, uint16_t num_channels, uint16_t bits_per_sample) {
+	return wav_file_create(p_wav_file, file_path, sample_rate, num_channels, bits_per_sample, false);
+}
+
+/**
+ * @brief Create a headerless file of interleaved little endian PCM samples, the same data a WAV file holds.
+ *
+ * @param p_wav_file
+ * @param file_path
+ * @param sample_rate
+ * @param num_channels
+ * @param bits_per_sample 16 or 32
+ * @return
+ */
+ret_code_t wav_file_open_raw(wav_file_t *p_wav_file, const char *file_path, uint32_t sample_rate, uint16_t num_channels, uint16_t bits_per_sample) {
+	return wav_file_create(p_wav_file, file_path, sample_rate, num_channels, bits_per_sample, true);
+}
+
+/**
+ * @brief Append interleaved full scale int32 samples, truncated to the bit depth of the file.
+ *
+ * @param p_wav_file
+ * @param p_samples num_frames * num_channels samples
+ * @param num_frames
+ * @return
+ */
+ret_code_t wav_file_write(wav_file_t *p_wav_file, const int32_t *p_samples, uint32_t num_frames) {
+	uint8_t buffer[1024 * 4];
+	uint32_t bytes_per_sample = p_wav_file->bits_per_sample / 8;
+	uint32_t num_samples = num_frames * p_wav_file->num_channels;
+	uint32_t buffer_idx = 0;
+
+	for (uint32_t i = 0; i < num_samples; i++) {
+		if (bytes_per_sample == 2) {
+			write_u16_le(&buffer[buffer_idx], (uint16_t) (p_samples[i] >> 16));
+		} else {
+			write_u32_le(&buffer[buffer_idx], (uint32_t) p_samples[i]);
+		}
+		buffer_idx += bytes_per_sample;
+
+		if (buffer_idx == sizeof(buffer) || i == num_samples - 1) {
+			if (fwrite(buffer, 1, buffer_idx, p_wav_file->file) != buffer_idx) {
+				log_error("Failed to write WAV data");
+				return RET_CODE_ERROR;
+			}
+			buffer_idx = 0;
+		}
+	}
+
+	p_wav_file->num_frames += num_frames;
+
+	return RET_CODE_OK;
+}
+
+ret_code_t wav_file_close(wav_file_t *p_wav_file) {
+	ret_code_t ret = wav_file_write_header(p_wav_file);
+	fclose(p_wav_file->file);
+	p_wav_file->file = NULL;
+	return ret;
+}
@@ -0,0 +1,30 @@
+//
+// Created by Tim Holzhey on 17.10.26
+//
+
+#ifndef FM_SYNTHESIZER_WAV_FILE_H
+#define FM_SYNTHESIZER_WAV_FILE_H
+
+#include "common.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct {
+	FILE *file;
+	uint32_t sample_rate;
+	uint16_t num_channels;
+	uint16_t bits_per_sample;
+	uint32_t num_frames;
+	bool raw;
+} wav_file_t;
+
+ret_code_t wav_file_open(wav_file_t *p_wav_file, const char *file_path, uint32_t sample_rate, uint16_t num_channels, uint16_t bits_per_sample);
+
+ret_code_t wav_file_open_raw(wav_file_t *p_wav_file, const char *file_path, uint32_t sample_rate, uint16_t num_channels, uint16_t bits_per_sample);
+
+ret_code_t wav_file_write(wav_file_t *p_wav_file, const int32_t *p_samples, uint32_t num_frames);
+
+ret_code_t wav_file_close(wav_file_t *p_wav_file);
+
+#endif //FM_SYNTHESIZER_WAV_FILE_H
@@ -0,0 +1,103 @@
+//
+// Created by Tim Holzhey on 17.10.26
+//
+
+#include <time.h>
+#include "midi_queue.h"
+
+/**
+ * @brief Get the current monotonic time used to timestamp MIDI events.
+ *
+ * @return time in nanoseconds
+ */
+uint64_t midi_queue_timestamp_now(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec;
+}
+
+void midi_queue_init(midi_queue_t *p_queue) {
+	atomic_init(&p_queue->write_index, 0);
+	atomic_init(&p_queue->read_index, 0);
+	atomic_init(&p_queue->num_dropped, 0);
+	atomic_init(&p_queue->num_overflowed, 0);
+}
+
+/**
+ * @brief Enqueue an event. Must only be called from the producer thread.
+ *
+ * @param p_queue
+ * @param p_event
+ * @return RET_CODE_ERROR if the queue is full, the event is counted as overflowed
+ */
+ret_code_t midi_queue_push(midi_queue_t *p_queue, const midi_event_t *p_event) {
+	uint32_t write_index = atomic_load_explicit(&p_queue->write_index, memory_order_relaxed);
+	uint32_t read_index = atomic_load_explicit(&p_queue->read_index, memory_order_acquire);
+
+	if (write_index - read_index >= MIDI_QUEUE_SIZE) {
+		atomic_fetch_add_explicit(&p_queue->num_overflowed, 1, memory_order_relaxed);
+		return RET_CODE_ERROR;
+	}
+
+	p_queue->events[write_index & MIDI_QUEUE_MASK] = *p_event;
+	atomic_store_explicit(&p_queue->write_index, write_index + 1, memory_order_release);
+
+	return RET_CODE_OK;
+}
+
+/**
+ * @brief Read the oldest event without dequeuing it. Must only be called from the consumer thread.
+ *
+ * @param p_queue
+ * @param p_event
+ * @return false if the queue is empty
+ */
+bool midi_queue_peek(midi_queue_t *p_queue, midi_event_t *p_event) {
+	uint32_t read_index = atomic_load_explicit(&p_queue->read_index, memory_order_relaxed);
+	uint32_t write_index = atomic_load_explicit(&p_queue->write_index, memory_order_acquire);
+
+	if (read_index == write_index) {
+		return false;
+	}
+
+	*p_event = p_queue->events[read_index & MIDI_QUEUE_MASK];
+
+	return true;
+}
+
+/**
+ * @brief Dequeue the oldest event. Must only be called from the consumer thread.
+ *
+ * @param p_queue
+ * @param p_event
+ * @return false if the queue is empty
+ */
+bool midi_queue_pop(midi_queue_t *p_queue, midi_event_t *p_event) {
+	uint32_t read_index = atomic_load_explicit(&p_queue->read_index, memory_order_relaxed);
+	uint32_t write_index = atomic_load_explicit(&p_queue->write_index, memory_order_acquire);
+
+	if (read_index == write_index) {
+		return false;
+	}
+
+	*p_event = p_queue->events[read_index & MIDI_QUEUE_MASK];
+	atomic_store_explicit(&p_queue->read_index, read_index + 1, memory_order_release);
+
+	return true;
+}
+
+/**
+ * @brief Count an event that was rejected or could not be applied (e.g. no free voice).
+ *
+ * @param p_queue
+ */
+void midi_queue_count_dropped(midi_queue_t *p_queue) {
+	atomic_fetch_add_explicit(&p_queue->num_dropped, 1, memory_order_relaxed);
+}
+
+void midi_queue_get_counters(midi_queue_t *p_queue, midi_queue_counters_t *p_counters) {
+	p_counters->num_dropped = atomic_load_explicit(&p_queue->num_dropped, memory_order_relaxed);
+	p_counters->num_overflowed = atomic_load_explicit(&p_queue->num_overflowed, memory_order_relaxed);
+	p_counters->num_pending = atomic_load_explicit(&p_queue->write_index, memory_order_acquire) -
+							  atomic_load_explicit(&p_queue->read_index, memory_order_acquire);
+}
@@ -0,0 +1,60 @@
+//
+// Created by Tim Holzhey on 17.10.26
+//
+
+#ifndef FM_SYNTHESIZER_MIDI_QUEUE_H
+#define FM_SYNTHESIZER_MIDI_QUEUE_H
+
+#include "common.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#define MIDI_QUEUE_SIZE					256
+#define MIDI_QUEUE_MASK					(MIDI_QUEUE_SIZE - 1)
+
+#define MIDI_STATUS_NOTE_OFF			0x80
+#define MIDI_STATUS_NOTE_ON				0x90
+#define MIDI_STATUS_CONTROL_CHANGE		0xB0
+
+#define MIDI_CONTROL_ALL_SOUND_OFF		120
+
+typedef struct {
+	uint64_t timestamp_ns;
+	uint8_t status;
+	uint8_t data1;
+	uint8_t data2;
+} midi_event_t;
+
+/**
+ * Wait-free single producer (web server thread) / single consumer (audio thread) ring of MIDI events.
+ */
+typedef struct {
+	midi_event_t events[MIDI_QUEUE_SIZE];
+	atomic_uint write_index;
+	atomic_uint read_index;
+	atomic_uint num_dropped;
+	atomic_uint num_overflowed;
+} midi_queue_t;
+
+typedef struct {
+	uint32_t num_dropped;
+	uint32_t num_overflowed;
+	uint32_t num_pending;
+} midi_queue_counters_t;
+
+uint64_t midi_queue_timestamp_now(void);
+
+void midi_queue_init(midi_queue_t *p_queue);
+
+ret_code_t midi_queue_push(midi_queue_t *p_queue, const midi_event_t *p_event);
+
+bool midi_queue_peek(midi_queue_t *p_queue, midi_event_t *p_event);
+
+bool midi_queue_pop(midi_queue_t *p_queue, midi_event_t *p_event);
+
+void midi_queue_count_dropped(midi_queue_t *p_queue);
+
+void midi_queue_get_counters(midi_queue_t *p_queue, midi_queue_counters_t *p_counters);
+
+#endif //FM_SYNTHESIZER_MIDI_QUEUE_H
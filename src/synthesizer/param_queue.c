@@ -0,0 +1,286 @@
+//
+// Created by Tim Holzhey on 17.10.26
+//
+
+#include "param_queue.h"
+#include "config.h"
+
+// Largest value of every parameter, as stored in voice_params_t
+static const uint8_t param_max_values[PARAM_ID_COUNT] = {
+		[PARAM_ID_ENV_RATE_1] = 99,
+		[PARAM_ID_ENV_RATE_2] = 99,
+		[PARAM_ID_ENV_RATE_3] = 99,
+		[PARAM_ID_ENV_RATE_4] = 99,
+		[PARAM_ID_ENV_LEVEL_1] = 99,
+		[PARAM_ID_ENV_LEVEL_2] = 99,
+		[PARAM_ID_ENV_LEVEL_3] = 99,
+		[PARAM_ID_ENV_LEVEL_4] = 99,
+		[PARAM_ID_KLS_BREAK_POINT] = 99,
+		[PARAM_ID_KLS_LEFT_DEPTH] = 99,
+		[PARAM_ID_KLS_RIGHT_DEPTH] = 99,
+		[PARAM_ID_KLS_LEFT_CURVE] = 3,
+		[PARAM_ID_KLS_RIGHT_CURVE] = 3,
+		[PARAM_ID_OSC_MODE] = 1,
+		[PARAM_ID_OSC_FREQUENCY_COARSE] = 31,
+		[PARAM_ID_OSC_FREQUENCY_FINE] = 99,
+		[PARAM_ID_OSC_DETUNE] = 14,
+		[PARAM_ID_KEYBOARD_RATE_SCALING] = 7,
+		[PARAM_ID_AMPLITUDE_MODULATION_SENSITIVITY] = 3,
+		[PARAM_ID_KEY_VELOCITY_SENSITIVITY] = 7,
+		[PARAM_ID_OUTPUT_LEVEL] = 99,
+		[PARAM_ID_ALGORITHM] = 31,
+		[PARAM_ID_FEEDBACK] = 7,
+		[PARAM_ID_OSCILLATOR_KEY_SYNC] = 1,
+		[PARAM_ID_TRANSPOSE] = 48,
+		[PARAM_ID_PITCH_EG_RATE_1] = 99,
+		[PARAM_ID_PITCH_EG_RATE_2] = 99,
+		[PARAM_ID_PITCH_EG_RATE_3] = 99,
+		[PARAM_ID_PITCH_EG_RATE_4] = 99,
+		[PARAM_ID_PITCH_EG_LEVEL_1] = 99,
+		[PARAM_ID_PITCH_EG_LEVEL_2] = 99,
+		[PARAM_ID_PITCH_EG_LEVEL_3] = 99,
+		[PARAM_ID_PITCH_EG_LEVEL_4] = 99,
+		[PARAM_ID_LFO_SPEED] = 99,
+		[PARAM_ID_LFO_DELAY] = 99,
+		[PARAM_ID_LFO_PITCH_MODULATION_DEPTH] = 99,
+		[PARAM_ID_LFO_AMPLITUDE_MODULATION_DEPTH] = 99,
+		[PARAM_ID_LFO_SYNC] = 1,
+		[PARAM_ID_LFO_WAVE] = 5,
+		[PARAM_ID_LFO_PITCH_MODULATION_SENSITIVITY] = 7,
+};
+
+void param_queue_init(param_queue_t *p_queue) {
+	atomic_init(&p_queue->write_index, 0);
+	atomic_init(&p_queue->read_index, 0);
+	atomic_init(&p_queue->num_applied, 0);
+	atomic_init(&p_queue->num_rejected, 0);
+	atomic_init(&p_queue->num_overflowed, 0);
+}
+
+/**
+ * @brief Enqueue an edit. Must only be called from the producer thread.
+ *
+ * @param p_queue
+ * @param p_edit
+ * @return RET_CODE_ERROR if the queue is full, the edit is counted as overflowed
+ */
+ret_code_t param_queue_push(param_queue_t *p_queue, const param_edit_t *p_edit) {
+	uint32_t write_index = atomic_load_explicit(&p_queue->write_index, memory_order_relaxed);
+	uint32_t read_index = atomic_load_explicit(&p_queue->read_index, memory_order_acquire);
+
+	if (write_index - read_index >= PARAM_QUEUE_SIZE) {
+		atomic_fetch_add_explicit(&p_queue->num_overflowed, 1, memory_order_relaxed);
+		return RET_CODE_ERROR;
+	}
+
+	p_queue->edits[write_index & PARAM_QUEUE_MASK] = *p_edit;
+	atomic_store_explicit(&p_queue->write_index, write_index + 1, memory_order_release);
+
+	return RET_CODE_OK;
+}
+
+/**
+ * @brief Read the oldest edit without dequeuing it. Must only be called from the consumer thread.
+ *
+ * @param p_queue
+ * @param p_edit
+ * @return false if the queue is empty
+ */
+bool param_queue_peek(param_queue_t *p_queue, param_edit_t *p_edit) {
+	uint32_t read_index = atomic_load_explicit(&p_queue->read_index, memory_order_relaxed);
+	uint32_t write_index = atomic_load_explicit(&p_queue->write_index, memory_order_acquire);
+
+	if (read_index == write_index) {
+		return false;
+	}
+
+	*p_edit = p_queue->edits[read_index & PARAM_QUEUE_MASK];
+
+	return true;
+}
+
+/**
+ * @brief Dequeue the edit returned by the last param_queue_peek() and count it as applied. Must only be called
+ * from the consumer thread.
+ *
+ * @param p_queue
+ */
+void param_queue_pop(param_queue_t *p_queue) {
+	uint32_t read_index = atomic_load_explicit(&p_queue->read_index, memory_order_relaxed);
+	atomic_store_explicit(&p_queue->read_index, read_index + 1, memory_order_release);
+	atomic_fetch_add_explicit(&p_queue->num_applied, 1, memory_order_relaxed);
+}
+
+/**
+ * @brief Get the index the next edit is written at. Must only be called from the producer thread.
+ *
+ * @param p_queue
+ * @return write index
+ */
+uint32_t param_queue_get_write_index(param_queue_t *p_queue) {
+	return atomic_load_explicit(&p_queue->write_index, memory_order_relaxed);
+}
+
+/**
+ * @brief Drop the queued edits written before an index, e.g. the edits of a patch that was replaced. Must only be
+ * called from the consumer thread.
+ *
+ * @param p_queue
+ * @param index param_queue_get_write_index() at the time the edits became obsolete
+ */
+void param_queue_discard_before(param_queue_t *p_queue, uint32_t index) {
+	uint32_t read_index = atomic_load_explicit(&p_queue->read_index, memory_order_relaxed);
+	uint32_t write_index = atomic_load_explicit(&p_queue->write_index, memory_order_acquire);
+
+	if (index - read_index <= write_index - read_index) {
+		atomic_store_explicit(&p_queue->read_index, index, memory_order_release);
+	}
+}
+
+/**
+ * @brief Count an edit that was rejected before it was queued.
+ *
+ * @param p_queue
+ */
+void param_queue_count_rejected(param_queue_t *p_queue) {
+	atomic_fetch_add_explicit(&p_queue->num_rejected, 1, memory_order_relaxed);
+}
+
+void param_queue_get_counters(param_queue_t *p_queue, param_queue_counters_t *p_counters) {
+	p_counters->num_applied = atomic_load_explicit(&p_queue->num_applied, memory_order_relaxed);
+	p_counters->num_rejected = atomic_load_explicit(&p_queue->num_rejected, memory_order_relaxed);
+	p_counters->num_overflowed = atomic_load_explicit(&p_queue->num_overflowed, memory_order_relaxed);
+	p_counters->num_pending = atomic_load_explicit(&p_queue->write_index, memory_order_acquire) -
+							  atomic_load_explicit(&p_queue->read_index, memory_order_acquire);
+}
+
+/**
+ * @brief Check the parameter id, operator and value range of an edit.
+ *
+ * @param p_edit
+ * @return RET_CODE_ERROR if the edit does not address a parameter or the value is out of range
+ */
+ret_code_t param_edit_validate(const param_edit_t *p_edit) {
+	if (p_edit->param_id >= PARAM_ID_COUNT) {
+		return RET_CODE_ERROR;
+	}
+
+	if (p_edit->param_id < PARAM_ID_NUM_OPERATOR && p_edit->operator_idx >= NUM_OPERATORS) {
+		return RET_CODE_ERROR;
+	}
+
+	return p_edit->value <= param_max_values[p_edit->param_id] ? RET_CODE_OK : RET_CODE_ERROR;
+}
+
+/**
+ * @brief Write a validated edit into patch parameters.
+ *
+ * @param p_params
+ * @param p_edit
+ * @return PARAM_EFFECT_x mask of the derived data to recompute
+ */
+uint32_t param_edit_apply(voice_params_t *p_params, const param_edit_t *p_edit) {
+	operator_params_t *p_op = &p_params->operators[p_edit->param_id < PARAM_ID_NUM_OPERATOR ? p_edit->operator_idx : 0];
+	uint8_t value = p_edit->value;
+
+	switch ((param_id_t) p_edit->param_id) {
+		case PARAM_ID_ENV_RATE_1:
+		case PARAM_ID_ENV_RATE_2:
+		case PARAM_ID_ENV_RATE_3:
+		case PARAM_ID_ENV_RATE_4:
+			p_op->env.rates[p_edit->param_id - PARAM_ID_ENV_RATE_1] = value;
+			return PARAM_EFFECT_ENVELOPE;
+		case PARAM_ID_ENV_LEVEL_1:
+		case PARAM_ID_ENV_LEVEL_2:
+		case PARAM_ID_ENV_LEVEL_3:
+		case PARAM_ID_ENV_LEVEL_4:
+			p_op->env.levels[p_edit->param_id - PARAM_ID_ENV_LEVEL_1] = value;
+			return PARAM_EFFECT_ENVELOPE;
+		case PARAM_ID_KLS_BREAK_POINT:
+			p_op->kls.break_point = value;
+			return PARAM_EFFECT_NONE;
+		case PARAM_ID_KLS_LEFT_DEPTH:
+			p_op->kls.left_depth = value;
+			return PARAM_EFFECT_NONE;
+		case PARAM_ID_KLS_RIGHT_DEPTH:
+			p_op->kls.right_depth = value;
+			return PARAM_EFFECT_NONE;
+		case PARAM_ID_KLS_LEFT_CURVE:
+			p_op->kls.left_curve = value;
+			return PARAM_EFFECT_NONE;
+		case PARAM_ID_KLS_RIGHT_CURVE:
+			p_op->kls.right_curve = value;
+			return PARAM_EFFECT_NONE;
+		case PARAM_ID_OSC_MODE:
+			p_op->osc.mode = value;
+			return PARAM_EFFECT_FREQUENCY;
+		case PARAM_ID_OSC_FREQUENCY_COARSE:
+			p_op->osc.frequency_coarse = value;
+			return PARAM_EFFECT_FREQUENCY;
+		case PARAM_ID_OSC_FREQUENCY_FINE:
+			p_op->osc.frequency_fine = value;
+			return PARAM_EFFECT_FREQUENCY;
+		case PARAM_ID_OSC_DETUNE:
+			p_op->osc.detune = value;
+			return PARAM_EFFECT_FREQUENCY;
+		case PARAM_ID_KEYBOARD_RATE_SCALING:
+			p_op->keyboard_rate_scaling = value;
+			return PARAM_EFFECT_NONE;
+		case PARAM_ID_AMPLITUDE_MODULATION_SENSITIVITY:
+			p_op->amplitude_modulation_sensitivity = value;
+			return PARAM_EFFECT_NONE;
+		case PARAM_ID_KEY_VELOCITY_SENSITIVITY:
+			p_op->key_velocity_sensitivity = value;
+			return PARAM_EFFECT_NONE;
+		case PARAM_ID_OUTPUT_LEVEL:
+			p_op->output_level = value;
+			return PARAM_EFFECT_ENVELOPE;
+		case PARAM_ID_ALGORITHM:
+			p_params->algorithm = value;
+			return PARAM_EFFECT_ROUTING;
+		case PARAM_ID_FEEDBACK:
+			p_params->feedback = value;
+			return PARAM_EFFECT_ROUTING;
+		case PARAM_ID_OSCILLATOR_KEY_SYNC:
+			p_params->oscillator_key_sync = value;
+			return PARAM_EFFECT_NONE;
+		case PARAM_ID_TRANSPOSE:
+			p_params->transpose = value;
+			return PARAM_EFFECT_NONE;
+		case PARAM_ID_PITCH_EG_RATE_1:
+		case PARAM_ID_PITCH_EG_RATE_2:
+		case PARAM_ID_PITCH_EG_RATE_3:
+		case PARAM_ID_PITCH_EG_RATE_4:
+			p_params->pitch_eg.rates[p_edit->param_id - PARAM_ID_PITCH_EG_RATE_1] = value;
+			return PARAM_EFFECT_NONE;
+		case PARAM_ID_PITCH_EG_LEVEL_1:
+		case PARAM_ID_PITCH_EG_LEVEL_2:
+		case PARAM_ID_PITCH_EG_LEVEL_3:
+		case PARAM_ID_PITCH_EG_LEVEL_4:
+			p_params->pitch_eg.levels[p_edit->param_id - PARAM_ID_PITCH_EG_LEVEL_1] = value;
+			return PARAM_EFFECT_NONE;
+		case PARAM_ID_LFO_SPEED:
+			p_params->lfo.speed = value;
+			return PARAM_EFFECT_NONE;
+		case PARAM_ID_LFO_DELAY:
+			p_params->lfo.delay = value;
+			return PARAM_EFFECT_NONE;
+		case PARAM_ID_LFO_PITCH_MODULATION_DEPTH:
+			p_params->lfo.pitch_modulation_depth = value;
+			return PARAM_EFFECT_NONE;
+		case PARAM_ID_LFO_AMPLITUDE_MODULATION_DEPTH:
+			p_params->lfo.amplitude_modulation_depth = value;
+			return PARAM_EFFECT_NONE;
+		case PARAM_ID_LFO_SYNC:
+			p_params->lfo.sync = value;
+			return PARAM_EFFECT_NONE;
+		case PARAM_ID_LFO_WAVE:
+			p_params->lfo.wave = value;
+			return PARAM_EFFECT_NONE;
+		case PARAM_ID_LFO_PITCH_MODULATION_SENSITIVITY:
+			p_params->lfo.pitch_modulation_sensitivity = value;
+			return PARAM_EFFECT_NONE;
+		default:
+			return PARAM_EFFECT_NONE;
+	}
+}
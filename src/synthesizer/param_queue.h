@@ -0,0 +1,120 @@
+//
+// Created by Tim Holzhey on 17.10.26
+//
+
+#ifndef FM_SYNTHESIZER_PARAM_QUEUE_H
+#define FM_SYNTHESIZER_PARAM_QUEUE_H
+
+#include "common.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "patch_file.h"
+
+#define PARAM_QUEUE_SIZE				256
+#define PARAM_QUEUE_MASK				(PARAM_QUEUE_SIZE - 1)
+
+// Wire format of an edit: operator, parameter id, value
+#define PARAM_EDIT_MESSAGE_SIZE			3
+
+/**
+ * Editable patch parameters. The ids below PARAM_ID_NUM_OPERATOR address a field of one operator, the others a
+ * field of the patch and ignore the operator.
+ */
+typedef enum {
+	PARAM_ID_ENV_RATE_1,
+	PARAM_ID_ENV_RATE_2,
+	PARAM_ID_ENV_RATE_3,
+	PARAM_ID_ENV_RATE_4,
+	PARAM_ID_ENV_LEVEL_1,
+	PARAM_ID_ENV_LEVEL_2,
+	PARAM_ID_ENV_LEVEL_3,
+	PARAM_ID_ENV_LEVEL_4,
+	PARAM_ID_KLS_BREAK_POINT,
+	PARAM_ID_KLS_LEFT_DEPTH,
+	PARAM_ID_KLS_RIGHT_DEPTH,
+	PARAM_ID_KLS_LEFT_CURVE,
+	PARAM_ID_KLS_RIGHT_CURVE,
+	PARAM_ID_OSC_MODE,
+	PARAM_ID_OSC_FREQUENCY_COARSE,
+	PARAM_ID_OSC_FREQUENCY_FINE,
+	PARAM_ID_OSC_DETUNE,
+	PARAM_ID_KEYBOARD_RATE_SCALING,
+	PARAM_ID_AMPLITUDE_MODULATION_SENSITIVITY,
+	PARAM_ID_KEY_VELOCITY_SENSITIVITY,
+	PARAM_ID_OUTPUT_LEVEL,
+	PARAM_ID_NUM_OPERATOR,
+	PARAM_ID_ALGORITHM = PARAM_ID_NUM_OPERATOR,
+	PARAM_ID_FEEDBACK,
+	PARAM_ID_OSCILLATOR_KEY_SYNC,
+	PARAM_ID_TRANSPOSE,
+	PARAM_ID_PITCH_EG_RATE_1,
+	PARAM_ID_PITCH_EG_RATE_2,
+	PARAM_ID_PITCH_EG_RATE_3,
+	PARAM_ID_PITCH_EG_RATE_4,
+	PARAM_ID_PITCH_EG_LEVEL_1,
+	PARAM_ID_PITCH_EG_LEVEL_2,
+	PARAM_ID_PITCH_EG_LEVEL_3,
+	PARAM_ID_PITCH_EG_LEVEL_4,
+	PARAM_ID_LFO_SPEED,
+	PARAM_ID_LFO_DELAY,
+	PARAM_ID_LFO_PITCH_MODULATION_DEPTH,
+	PARAM_ID_LFO_AMPLITUDE_MODULATION_DEPTH,
+	PARAM_ID_LFO_SYNC,
+	PARAM_ID_LFO_WAVE,
+	PARAM_ID_LFO_PITCH_MODULATION_SENSITIVITY,
+	PARAM_ID_COUNT,
+} param_id_t;
+
+// Data derived from an edited parameter that has to be recomputed
+#define PARAM_EFFECT_NONE				0x0
+#define PARAM_EFFECT_ENVELOPE			0x1
+#define PARAM_EFFECT_FREQUENCY			0x2
+#define PARAM_EFFECT_ROUTING			0x4
+
+typedef struct {
+	uint8_t operator_idx;
+	uint8_t param_id;
+	uint8_t value;
+} param_edit_t;
+
+/**
+ * Wait-free single producer (web server thread) / single consumer (audio thread) ring of parameter edits.
+ */
+typedef struct {
+	param_edit_t edits[PARAM_QUEUE_SIZE];
+	atomic_uint write_index;
+	atomic_uint read_index;
+	atomic_uint num_applied;
+	atomic_uint num_rejected;
+	atomic_uint num_overflowed;
+} param_queue_t;
+
+typedef struct {
+	uint32_t num_applied;
+	uint32_t num_rejected;
+	uint32_t num_overflowed;
+	uint32_t num_pending;
+} param_queue_counters_t;
+
+void param_queue_init(param_queue_t *p_queue);
+
+ret_code_t param_queue_push(param_queue_t *p_queue, const param_edit_t *p_edit);
+
+bool param_queue_peek(param_queue_t *p_queue, param_edit_t *p_edit);
+
+void param_queue_pop(param_queue_t *p_queue);
+
+uint32_t param_queue_get_write_index(param_queue_t *p_queue);
+
+void param_queue_discard_before(param_queue_t *p_queue, uint32_t index);
+
+void param_queue_count_rejected(param_queue_t *p_queue);
+
+void param_queue_get_counters(param_queue_t *p_queue, param_queue_counters_t *p_counters);
+
+ret_code_t param_edit_validate(const param_edit_t *p_edit);
+
+uint32_t param_edit_apply(voice_params_t *p_params, const param_edit_t *p_edit);
+
+#endif //FM_SYNTHESIZER_PARAM_QUEUE_H
@@ -22,14 +22,7 @@ const char *rom_names[PATCH_FILE_ROM_COUNT] = {
 		[PATCH_FILE_ROM_VRC112A]	= "vrc112a.syx",
 };
 
-static struct {
-	bool is_loaded;
-	patch_file_rom_t current_patch_file;
-	uint8_t current_patch_number;
-	voice_params_t current_voice_params[PATCH_FILE_NUM_VOICES];
-} m_patch_file;
-
-static enum {
+typedef enum {
 	SYSEX_PARSE_STATE_STATUS_START,
 	SYSEX_PARSE_STATE_ID,
 	SYSEX_PARSE_STATE_SUB_STATUS_CHANNEL,
@@ -39,9 +32,9 @@ static enum {
 	SYSEX_PARSE_STATE_CHECKSUM,
 	SYSEX_PARSE_STATE_STATUS_END,
 	SYSEX_PARSE_STATE_DONE,
-} sysex_parse_state;
+} sysex_parse_state_t;
 
-static struct {
+typedef struct {
 	uint8_t id:7;
 	uint8_t sub_status:3;
 	uint8_t channel:4;
@@ -49,26 +42,22 @@ static struct {
 	uint16_t byte_count:14;
 	const uint8_t *p_data;
 	uint8_t checksum:7;
-} sysex_file;
+} sysex_file_t;
 
 static ret_code_t patch_file_decode(const uint8_t *p_data, uint32_t data_len, voice_params_t *p_voice_params);
 
-ret_code_t patch_file_load_rom(patch_file_rom_t patch_file) {
-	if (patch_file >= PATCH_FILE_ROM_COUNT) {
-		log_error("Invalid patch file: %u", patch_file);
-		return RET_CODE_ERROR;
-	}
-
-	if (m_patch_file.is_loaded && m_patch_file.current_patch_file == patch_file) {
-		return RET_CODE_OK;
-	}
-
+/**
+ * @brief Read and decode a 32 voice bank SysEx file.
+ *
+ * @param file_path
+ * @param p_voice_params output, PATCH_FILE_NUM_VOICES entries
+ * @return
+ */
+ret_code_t patch_file_read_bank(const char *file_path, voice_params_t *p_voice_params) {
 	// Open file
-	char file_path[256];
-	sprintf(file_path, "%s/%s", PATCH_FILE_DIR, rom_names[patch_file]);
 	FILE *file = fopen(file_path, "rb");
 	if (!file) {
-		log_error("Failed to open file");
+		log_error("Failed to open file: %s", file_path);
 		return RET_CODE_ERROR;
 	}
 
@@ -79,32 +68,84 @@ ret_code_t patch_file_load_rom(patch_file_rom_t patch_file) {
 	uint8_t *buffer = malloc(file_size);
 	if (!buffer) {
 		log_error("Failed to allocate memory");
+		fclose(file);
+		return RET_CODE_ERROR;
+	}
+	if (fread(buffer, 1, file_size, file) != (size_t) file_size) {
+		log_error("Failed to read file: %s", file_path);
+		fclose(file);
+		free(buffer);
 		return RET_CODE_ERROR;
 	}
-	fread(buffer, file_size, 1, file);
 	fclose(file);
 
 	// Parse buffer
-	if (patch_file_decode(buffer, file_size, m_patch_file.current_voice_params) != RET_CODE_OK) {
-		log_error("Failed to decode patch file");
-		return RET_CODE_ERROR;
+	ret_code_t ret = patch_file_decode(buffer, file_size, p_voice_params);
+	if (ret != RET_CODE_OK) {
+		log_error("Failed to decode patch file: %s", file_path);
 	}
 
 	// Free buffer
 	free(buffer);
 
-	m_patch_file.current_patch_file = patch_file;
-	m_patch_file.is_loaded = true;
+	return ret;
+}
+
+/**
+ * @brief Initialize a bank context, no bank is loaded afterwards.
+ *
+ * @param p_patch_file
+ */
+void patch_file_init(patch_file_t *p_patch_file) {
+	p_patch_file->is_loaded = false;
+	p_patch_file->current_patch_file = PATCH_FILE_ROM_COUNT;
+	p_patch_file->current_patch_number = 0;
+}
+
+ret_code_t patch_file_load_rom(patch_file_t *p_patch_file, patch_file_rom_t patch_file) {
+	if (patch_file >= PATCH_FILE_ROM_COUNT) {
+		log_error("Invalid patch file: %u", patch_file);
+		return RET_CODE_ERROR;
+	}
+
+	if (p_patch_file->is_loaded && p_patch_file->current_patch_file == patch_file) {
+		return RET_CODE_OK;
+	}
+
+	char file_path[256];
+	sprintf(file_path, "%s/%s", PATCH_FILE_DIR, rom_names[patch_file]);
+	RET_ON_FAIL(patch_file_read_bank(file_path, p_patch_file->current_voice_params));
+
+	p_patch_file->current_patch_file = patch_file;
+	p_patch_file->is_loaded = true;
 
 	log_info("Loaded patch file: %s", rom_names[patch_file]);
 
 	return RET_CODE_OK;
 }
 
-ret_code_t patch_file_load_rom_by_name(const char *rom_name) {
+/**
+ * @brief Load a bank from an arbitrary SysEx file. The current ROM is PATCH_FILE_ROM_COUNT afterwards.
+ *
+ * @param p_patch_file
+ * @param file_path
+ * @return
+ */
+ret_code_t patch_file_load_path(patch_file_t *p_patch_file, const char *file_path) {
+	RET_ON_FAIL(patch_file_read_bank(file_path, p_patch_file->current_voice_params));
+
+	p_patch_file->current_patch_file = PATCH_FILE_ROM_COUNT;
+	p_patch_file->is_loaded = true;
+
+	log_info("Loaded patch file: %s", file_path);
+
+	return RET_CODE_OK;
+}
+
+ret_code_t patch_file_load_rom_by_name(patch_file_t *p_patch_file, const char *rom_name) {
 	for (uint32_t i = 0; i < PATCH_FILE_ROM_COUNT; i++) {
 		if (strcmp(rom_name, rom_names[i]) == 0) {
-			return patch_file_load_rom(i);
+			return patch_file_load_rom(p_patch_file, i);
 		}
 	}
 
@@ -113,8 +154,8 @@ ret_code_t patch_file_load_rom_by_name(const char *rom_name) {
 	return RET_CODE_ERROR;
 }
 
-ret_code_t patch_file_load_patch(uint8_t patch_number, voice_params_t *voice_params) {
-	if (!m_patch_file.is_loaded) {
+ret_code_t patch_file_load_patch(patch_file_t *p_patch_file, uint8_t patch_number, voice_params_t *voice_params) {
+	if (!p_patch_file->is_loaded) {
 		log_error("No patch file loaded");
 		return RET_CODE_ERROR;
 	}
@@ -124,24 +165,24 @@ ret_code_t patch_file_load_patch(uint8_t patch_number, voice_params_t *voice_par
 		return RET_CODE_ERROR;
 	}
 
-	memcpy(voice_params, &m_patch_file.current_voice_params[patch_number], sizeof(voice_params_t));
+	memcpy(voice_params, &p_patch_file->current_voice_params[patch_number], sizeof(voice_params_t));
 
-	m_patch_file.current_patch_number = patch_number;
+	p_patch_file->current_patch_number = patch_number;
 
 	log_info("Loaded patch number: %u", patch_number);
 
 	return RET_CODE_OK;
 }
 
-ret_code_t patch_file_load_patch_by_name(const char *patch_name, voice_params_t *voice_params) {
-	if (!m_patch_file.is_loaded) {
+ret_code_t patch_file_load_patch_by_name(patch_file_t *p_patch_file, const char *patch_name, voice_params_t *voice_params) {
+	if (!p_patch_file->is_loaded) {
 		log_error("No patch file loaded");
 		return RET_CODE_ERROR;
 	}
 
 	for (uint32_t i = 0; i < PATCH_FILE_NUM_VOICES; i++) {
-		if (strncmp(patch_name, m_patch_file.current_voice_params[i].name, sizeof(m_patch_file.current_voice_params[0].name)) == 0) {
-			return patch_file_load_patch(i, voice_params);
+		if (strncmp(patch_name, p_patch_file->current_voice_params[i].name, sizeof(p_patch_file->current_voice_params[0].name)) == 0) {
+			return patch_file_load_patch(p_patch_file, i, voice_params);
 		}
 	}
 
@@ -150,24 +191,24 @@ ret_code_t patch_file_load_patch_by_name(const char *patch_name, voice_params_t
 	return RET_CODE_ERROR;
 }
 
-bool patch_file_is_loaded(void) {
-	return m_patch_file.is_loaded;
+bool patch_file_is_loaded(patch_file_t *p_patch_file) {
+	return p_patch_file->is_loaded;
 }
 
-patch_file_rom_t patch_file_get_current_rom(void) {
-	return m_patch_file.current_patch_file;
+patch_file_rom_t patch_file_get_current_rom(patch_file_t *p_patch_file) {
+	return p_patch_file->current_patch_file;
 }
 
-uint8_t patch_file_get_current_patch_number(void) {
-	return m_patch_file.current_patch_number;
+uint8_t patch_file_get_current_patch_number(patch_file_t *p_patch_file) {
+	return p_patch_file->current_patch_number;
 }
 
 const char *patch_file_get_rom_names(void) {
 	return (const char *) rom_names;
 }
 
-voice_params_t *patch_file_get_voice_params(void) {
-	return m_patch_file.current_voice_params;
+voice_params_t *patch_file_get_voice_params(patch_file_t *p_patch_file) {
+	return p_patch_file->current_voice_params;
 }
 
 uint8_t twos_complement_checksum_7bit(const uint8_t *p_data, uint32_t data_len) {
@@ -248,7 +289,9 @@ ret_code_t yamaha_dx7_decode_voice_data(const uint8_t *p_data, uint32_t data_len
 }
 
 ret_code_t patch_file_decode(const uint8_t *p_data, uint32_t data_len, voice_params_t *p_voice_params) {
-	sysex_parse_state = SYSEX_PARSE_STATE_STATUS_START;
+	// Parser state is local, so banks can be decoded on several threads at once
+	sysex_parse_state_t sysex_parse_state = SYSEX_PARSE_STATE_STATUS_START;
+	sysex_file_t sysex_file = {0};
 
 	uint32_t bytes_consumed = 0;
 
@@ -72,17 +72,30 @@ typedef enum {
 	PATCH_FILE_ROM_COUNT,
 } patch_file_rom_t;
 
-ret_code_t patch_file_load_rom(patch_file_rom_t patch_file);
-ret_code_t patch_file_load_rom_by_name(const char *rom_name);
-bool patch_file_is_loaded(void);
+/**
+ * Bank context: the voices of the loaded SysEx bank and the current selection.
+ */
+typedef struct {
+	bool is_loaded;
+	patch_file_rom_t current_patch_file;
+	uint8_t current_patch_number;
+	voice_params_t current_voice_params[PATCH_FILE_NUM_VOICES];
+} patch_file_t;
+
+ret_code_t patch_file_read_bank(const char *file_path, voice_params_t *p_voice_params);
+void patch_file_init(patch_file_t *p_patch_file);
+ret_code_t patch_file_load_rom(patch_file_t *p_patch_file, patch_file_rom_t patch_file);
+ret_code_t patch_file_load_path(patch_file_t *p_patch_file, const char *file_path);
+ret_code_t patch_file_load_rom_by_name(patch_file_t *p_patch_file, const char *rom_name);
+bool patch_file_is_loaded(patch_file_t *p_patch_file);
 
-patch_file_rom_t patch_file_get_current_rom(void);
-uint8_t patch_file_get_current_patch_number(void);
+patch_file_rom_t patch_file_get_current_rom(patch_file_t *p_patch_file);
+uint8_t patch_file_get_current_patch_number(patch_file_t *p_patch_file);
 
-ret_code_t patch_file_load_patch(uint8_t patch_number, voice_params_t *voice_params);
-ret_code_t patch_file_load_patch_by_name(const char *patch_name, voice_params_t *voice_params);
+ret_code_t patch_file_load_patch(patch_file_t *p_patch_file, uint8_t patch_number, voice_params_t *voice_params);
+ret_code_t patch_file_load_patch_by_name(patch_file_t *p_patch_file, const char *patch_name, voice_params_t *voice_params);
 
 const char *patch_file_get_rom_names(void);
-voice_params_t *patch_file_get_voice_params(void);
+voice_params_t *patch_file_get_voice_params(patch_file_t *p_patch_file);
 
 #endif //FM_SYNTHESIZER_SYX_DECODER_H
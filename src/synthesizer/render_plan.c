@@ -0,0 +1,206 @@
+//
+// Created by Tim Holzhey on 17.10.26
+//
+
+#include "render_plan.h"
+#include <string.h>
+
+// The control thread builds, publishes and reclaims plans, only one thread may do so. The audio thread only ever
+// touches p_pending and the write side of the retired ring (render_plan_take(), render_plan_release() and
+// render_plan_is_pending()).
+
+#if RENDER_PLAN_CACHE_SIZE < 3
+#error "RENDER_PLAN_CACHE_SIZE must hold the rendered, the pending and a newly built plan"
+#endif
+
+#if (RENDER_PLAN_NUM_RETIRED & RENDER_PLAN_RETIRED_MASK) != 0
+#error "RENDER_PLAN_NUM_RETIRED must be a power of two"
+#endif
+
+#define FNV_OFFSET_BASIS		0xCBF29CE484222325ULL
+#define FNV_PRIME				0x100000001B3ULL
+
+void render_plan_cache_init(render_plan_cache_t *p_cache) {
+	memset(p_cache->valid, 0, sizeof(p_cache->valid));
+	memset(p_cache->num_refs, 0, sizeof(p_cache->num_refs));
+	memset(p_cache->last_used, 0, sizeof(p_cache->last_used));
+	p_cache->use_counter = 0;
+	p_cache->p_published = NULL;
+	atomic_init(&p_cache->p_pending, NULL);
+	atomic_init(&p_cache->retired_write_index, 0);
+	atomic_init(&p_cache->retired_read_index, 0);
+}
+
+/**
+ * @brief FNV-1a hash of the patch parameters, the cache key of their plan.
+ *
+ * @param p_params
+ * @return hash
+ */
+uint64_t render_plan_hash(const voice_params_t *p_params) {
+	const uint8_t *p_data = (const uint8_t *) p_params;
+	uint64_t hash = FNV_OFFSET_BASIS;
+	for (uint32_t i = 0; i < sizeof(voice_params_t); i++) {
+		hash ^= p_data[i];
+		hash *= FNV_PRIME;
+	}
+	return hash;
+}
+
+/**
+ * @brief Check whether a plan is a cache slot, plans outside the cache (e.g. the audio thread's edited copy) are
+ * not reference counted.
+ *
+ * @param p_cache
+ * @param p_plan
+ * @return true if the plan is in the cache
+ */
+static bool render_plan_is_cached(const render_plan_cache_t *p_cache, const render_plan_t *p_plan) {
+	uintptr_t address = (uintptr_t) p_plan;
+	return address >= (uintptr_t) p_cache->plans && address < (uintptr_t) (p_cache->plans + RENDER_PLAN_CACHE_SIZE);
+}
+
+/**
+ * @brief Drop the references the audio thread handed back.
+ *
+ * @param p_cache
+ */
+static void render_plan_collect(render_plan_cache_t *p_cache) {
+	uint32_t read_index = atomic_load_explicit(&p_cache->retired_read_index, memory_order_relaxed);
+	uint32_t write_index = atomic_load_explicit(&p_cache->retired_write_index, memory_order_acquire);
+
+	for (; read_index != write_index; read_index++) {
+		p_cache->num_refs[p_cache->p_retired[read_index & RENDER_PLAN_RETIRED_MASK] - p_cache->plans]--;
+	}
+	atomic_store_explicit(&p_cache->retired_read_index, read_index, memory_order_release);
+}
+
+/**
+ * @brief Look up the plan of a patch.
+ *
+ * @param p_cache
+ * @param p_params
+ * @param hash render_plan_hash() of p_params
+ * @return plan, NULL if the patch has none
+ */
+render_plan_t *render_plan_cache_find(render_plan_cache_t *p_cache, const voice_params_t *p_params, uint64_t hash) {
+	for (uint32_t i = 0; i < RENDER_PLAN_CACHE_SIZE; i++) {
+		render_plan_t *p_plan = &p_cache->plans[i];
+		if (p_cache->valid[i] && p_plan->hash == hash && memcmp(&p_plan->voice_params, p_params, sizeof(voice_params_t)) == 0) {
+			p_cache->last_used[i] = ++p_cache->use_counter;
+			return p_plan;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Get a slot to build a new plan in: an empty one or the least recently used plan nobody references.
+ * The slot is counted as valid, the caller must build the plan before the next cache call.
+ *
+ * @param p_cache
+ * @return slot, NULL if every plan is still referenced
+ */
+render_plan_t *render_plan_cache_get_slot(render_plan_cache_t *p_cache) {
+	render_plan_collect(p_cache);
+
+	int32_t slot_idx = -1;
+	for (uint32_t i = 0; i < RENDER_PLAN_CACHE_SIZE; i++) {
+		if (!p_cache->valid[i]) {
+			slot_idx = (int32_t) i;
+			break;
+		}
+		if (p_cache->num_refs[i] == 0 && (slot_idx < 0 || p_cache->last_used[i] < p_cache->last_used[slot_idx])) {
+			slot_idx = (int32_t) i;
+		}
+	}
+
+	if (slot_idx < 0) {
+		return NULL;
+	}
+
+	p_cache->valid[slot_idx] = true;
+	p_cache->last_used[slot_idx] = ++p_cache->use_counter;
+	return &p_cache->plans[slot_idx];
+}
+
+/**
+ * @brief Make a plan the one the audio thread renders with from its next buffer on. A plan that was published
+ * before and not yet taken is dropped. Publishing the current plan again reverts the audio thread's edits of it.
+ *
+ * @param p_cache
+ * @param p_plan cached plan
+ */
+void render_plan_publish(render_plan_cache_t *p_cache, render_plan_t *p_plan) {
+	render_plan_collect(p_cache);
+
+	p_cache->num_refs[p_plan - p_cache->plans]++;
+	render_plan_t *p_dropped = atomic_exchange_explicit(&p_cache->p_pending, p_plan, memory_order_acq_rel);
+	if (p_dropped != NULL) {
+		p_cache->num_refs[p_dropped - p_cache->plans]--;
+	}
+	p_cache->p_published = p_plan;
+}
+
+/**
+ * @brief Check whether a published plan waits to be taken. Audio thread only.
+ *
+ * @param p_cache
+ * @return true if render_plan_take() would switch plans
+ */
+bool render_plan_is_pending(render_plan_cache_t *p_cache) {
+	return atomic_load_explicit(&p_cache->p_pending, memory_order_acquire) != NULL;
+}
+
+/**
+ * @brief Hand a plan the audio thread no longer renders with back to the control thread. Audio thread only,
+ * wait-free.
+ *
+ * @param p_cache
+ * @param p_plan plan to release, NULL or plans outside the cache are ignored
+ * @return false if the retired ring is full, the plan is still referenced then
+ */
+bool render_plan_release(render_plan_cache_t *p_cache, render_plan_t *p_plan) {
+	if (p_plan == NULL || !render_plan_is_cached(p_cache, p_plan)) {
+		return true;
+	}
+
+	uint32_t write_index = atomic_load_explicit(&p_cache->retired_write_index, memory_order_relaxed);
+	uint32_t read_index = atomic_load_explicit(&p_cache->retired_read_index, memory_order_acquire);
+	if (write_index - read_index >= RENDER_PLAN_NUM_RETIRED) {
+		return false;
+	}
+
+	p_cache->p_retired[write_index & RENDER_PLAN_RETIRED_MASK] = p_plan;
+	atomic_store_explicit(&p_cache->retired_write_index, write_index + 1, memory_order_release);
+
+	return true;
+}
+
+/**
+ * @brief Take the published plan if there is a new one. The plan it replaces is handed back to the control thread.
+ * Audio thread only, wait-free.
+ *
+ * @param p_cache
+ * @param p_current plan the audio thread renders with, NULL if none
+ * @return new plan, NULL if there is none or the retired ring is full (retried with the next buffer)
+ */
+render_plan_t *render_plan_take(render_plan_cache_t *p_cache, render_plan_t *p_current) {
+	if (atomic_load_explicit(&p_cache->p_pending, memory_order_relaxed) == NULL) {
+		return NULL;
+	}
+
+	uint32_t write_index = atomic_load_explicit(&p_cache->retired_write_index, memory_order_relaxed);
+	uint32_t read_index = atomic_load_explicit(&p_cache->retired_read_index, memory_order_acquire);
+	if (write_index - read_index >= RENDER_PLAN_NUM_RETIRED) {
+		return NULL;
+	}
+
+	render_plan_t *p_plan = atomic_exchange_explicit(&p_cache->p_pending, NULL, memory_order_acq_rel);
+	if (p_plan != NULL) {
+		render_plan_release(p_cache, p_current);
+	}
+
+	return p_plan;
+}
@@ -0,0 +1,29 @@
+//
+// Created by Tim Holzhey on 17.10.26
+//
+
+#ifndef FM_SYNTHESIZER_RENDER_PLAN_H
+#define FM_SYNTHESIZER_RENDER_PLAN_H
+
+#include "common.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include "synthesizer.h"
+
+void render_plan_cache_init(render_plan_cache_t *p_cache);
+
+uint64_t render_plan_hash(const voice_params_t *p_params);
+
+render_plan_t *render_plan_cache_find(render_plan_cache_t *p_cache, const voice_params_t *p_params, uint64_t hash);
+
+render_plan_t *render_plan_cache_get_slot(render_plan_cache_t *p_cache);
+
+void render_plan_publish(render_plan_cache_t *p_cache, render_plan_t *p_plan);
+
+bool render_plan_is_pending(render_plan_cache_t *p_cache);
+
+bool render_plan_release(render_plan_cache_t *p_cache, render_plan_t *p_plan);
+
+render_plan_t *render_plan_take(render_plan_cache_t *p_cache, render_plan_t *p_current);
+
+#endif //FM_SYNTHESIZER_RENDER_PLAN_H
@@ -0,0 +1,61 @@
+//
+// Created by Tim Holzhey on 17.10.26
+//
+
+#include "render_profile.h"
+
+const char *const render_stage_names[RENDER_STAGE_COUNT] = {
+		[RENDER_STAGE_FREQUENCY] = "frequency",
+		[RENDER_STAGE_ENVELOPE] = "envelope",
+		[RENDER_STAGE_LOOKUP] = "lookup",
+		[RENDER_STAGE_ROUTING] = "routing",
+		[RENDER_STAGE_VISUALIZATION] = "visualization",
+};
+
+void render_profile_init(render_profile_t *p_profile) {
+	for (uint32_t algorithm = 0; algorithm < RENDER_PROFILE_NUM_ALGORITHMS; algorithm++) {
+		for (uint32_t stage = 0; stage < RENDER_STAGE_COUNT; stage++) {
+			atomic_init(&p_profile->ticks[algorithm][stage], 0);
+		}
+		atomic_init(&p_profile->num_frames[algorithm], 0);
+	}
+}
+
+/**
+ * @brief Read the counters from any thread. All zero unless built with SYNTH_PROFILE_STAGES.
+ *
+ * @param p_profile
+ * @param p_snapshot
+ */
+void render_profile_get(render_profile_t *p_profile, render_profile_snapshot_t *p_snapshot) {
+	for (uint32_t algorithm = 0; algorithm < RENDER_PROFILE_NUM_ALGORITHMS; algorithm++) {
+		for (uint32_t stage = 0; stage < RENDER_STAGE_COUNT; stage++) {
+			p_snapshot->ticks[algorithm][stage] = atomic_load_explicit(&p_profile->ticks[algorithm][stage], memory_order_relaxed);
+		}
+		p_snapshot->num_frames[algorithm] = atomic_load_explicit(&p_profile->num_frames[algorithm], memory_order_relaxed);
+	}
+}
+
+#if SYNTH_PROFILE_STAGES
+_Thread_local uint64_t render_profile_thread_ticks[RENDER_STAGE_COUNT];
+
+/**
+ * @brief Move the stage time the calling thread accumulated since its last flush to an algorithm.
+ *
+ * @param p_profile
+ * @param algorithm 0..RENDER_PROFILE_NUM_ALGORITHMS - 1
+ * @param num_frames frames rendered since the last flush of the audio thread, 0 on worker threads
+ */
+void render_profile_flush(render_profile_t *p_profile, uint8_t algorithm, uint32_t num_frames) {
+	algorithm = algorithm < RENDER_PROFILE_NUM_ALGORITHMS ? algorithm : RENDER_PROFILE_NUM_ALGORITHMS - 1;
+	for (uint32_t stage = 0; stage < RENDER_STAGE_COUNT; stage++) {
+		if (render_profile_thread_ticks[stage] != 0) {
+			atomic_fetch_add_explicit(&p_profile->ticks[algorithm][stage], render_profile_thread_ticks[stage], memory_order_relaxed);
+			render_profile_thread_ticks[stage] = 0;
+		}
+	}
+	if (num_frames != 0) {
+		atomic_fetch_add_explicit(&p_profile->num_frames[algorithm], num_frames, memory_order_relaxed);
+	}
+}
+#endif
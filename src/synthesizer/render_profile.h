@@ -0,0 +1,80 @@
+//
+// Created by Tim Holzhey on 17.10.26
+//
+
+#ifndef FM_SYNTHESIZER_RENDER_PROFILE_H
+#define FM_SYNTHESIZER_RENDER_PROFILE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "config.h"
+
+#define RENDER_PROFILE_NUM_ALGORITHMS		32
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define RENDER_PROFILE_UNIT					"tsc"
+#else
+#include <time.h>
+#define RENDER_PROFILE_UNIT					"ns"
+#endif
+
+typedef enum {
+	RENDER_STAGE_FREQUENCY,
+	RENDER_STAGE_ENVELOPE,
+	RENDER_STAGE_LOOKUP,
+	RENDER_STAGE_ROUTING,
+	RENDER_STAGE_VISUALIZATION,
+	RENDER_STAGE_COUNT,
+} render_stage_t;
+
+/**
+ * Time spent per render stage and algorithm, in RENDER_PROFILE_UNIT ticks. Render threads accumulate into thread
+ * local counters and fold them in with render_profile_flush(), readers load any time without locking.
+ */
+typedef struct {
+	atomic_uint_fast64_t ticks[RENDER_PROFILE_NUM_ALGORITHMS][RENDER_STAGE_COUNT];
+	atomic_uint_fast64_t num_frames[RENDER_PROFILE_NUM_ALGORITHMS];
+} render_profile_t;
+
+typedef struct {
+	uint64_t ticks[RENDER_PROFILE_NUM_ALGORITHMS][RENDER_STAGE_COUNT];
+	uint64_t num_frames[RENDER_PROFILE_NUM_ALGORITHMS];
+} render_profile_snapshot_t;
+
+extern const char *const render_stage_names[RENDER_STAGE_COUNT];
+
+void render_profile_init(render_profile_t *p_profile);
+
+void render_profile_get(render_profile_t *p_profile, render_profile_snapshot_t *p_snapshot);
+
+#if SYNTH_PROFILE_STAGES
+extern _Thread_local uint64_t render_profile_thread_ticks[RENDER_STAGE_COUNT];
+
+static inline uint64_t render_profile_now(void) {
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec;
+#endif
+}
+
+// Start a stage timer, each lap adds the time since the previous lap to a stage of the calling thread
+#define RENDER_PROFILE_BEGIN(timer)			uint64_t timer = render_profile_now()
+#define RENDER_PROFILE_LAP(timer, stage)	do { \
+	uint64_t lap_now = render_profile_now(); \
+	render_profile_thread_ticks[stage] += lap_now - (timer); \
+	(timer) = lap_now; \
+} while (0)
+
+void render_profile_flush(render_profile_t *p_profile, uint8_t algorithm, uint32_t num_frames);
+#else
+#define RENDER_PROFILE_BEGIN(timer)
+#define RENDER_PROFILE_LAP(timer, stage)
+#define render_profile_flush(p_profile, algorithm, num_frames)
+#endif
+
+#endif //FM_SYNTHESIZER_RENDER_PROFILE_H
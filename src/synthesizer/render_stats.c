@@ -0,0 +1,104 @@
+//
+// Created by Tim Holzhey on 17.10.26
+//
+
+#include "render_stats.h"
+
+void render_stats_init(render_stats_t *p_stats) {
+	atomic_init(&p_stats->num_callbacks, 0);
+	atomic_init(&p_stats->num_frames, 0);
+	atomic_init(&p_stats->render_ns, 0);
+	atomic_init(&p_stats->period_ns, 0);
+	atomic_init(&p_stats->voice_sum, 0);
+	for (uint32_t i = 0; i < RENDER_STATS_NUM_LOAD_BUCKETS; i++) {
+		atomic_init(&p_stats->load_histogram[i], 0);
+	}
+	atomic_init(&p_stats->max_load_permille, 0);
+	atomic_init(&p_stats->last_load_permille, 0);
+	atomic_init(&p_stats->num_deadline_misses, 0);
+	atomic_init(&p_stats->num_underflows, 0);
+	atomic_init(&p_stats->num_overflows, 0);
+	atomic_init(&p_stats->num_voices, 0);
+	atomic_init(&p_stats->max_voices, 0);
+}
+
+/**
+ * @brief Record one callback. Must only be called from the audio thread, single writer read-modify-writes need no
+ * atomic exchange.
+ *
+ * @param p_stats
+ * @param render_ns time spent rendering
+ * @param period_ns duration of the rendered buffer
+ * @param num_frames frames rendered
+ * @param num_voices voices active during the callback
+ * @return load of the callback in permille of the buffer period
+ */
+uint32_t render_stats_record_callback(render_stats_t *p_stats, uint64_t render_ns, uint64_t period_ns,
+								  uint32_t num_frames, uint32_t num_voices) {
+	uint32_t load_permille = period_ns > 0 ? (uint32_t) (render_ns * 1000 / period_ns) : 0;
+	uint32_t bucket = load_permille / (RENDER_STATS_LOAD_BUCKET_PERCENT * 10);
+	bucket = bucket < RENDER_STATS_NUM_LOAD_BUCKETS ? bucket : RENDER_STATS_NUM_LOAD_BUCKETS - 1;
+
+	atomic_fetch_add_explicit(&p_stats->num_callbacks, 1, memory_order_relaxed);
+	atomic_fetch_add_explicit(&p_stats->num_frames, num_frames, memory_order_relaxed);
+	atomic_fetch_add_explicit(&p_stats->render_ns, render_ns, memory_order_relaxed);
+	atomic_fetch_add_explicit(&p_stats->period_ns, period_ns, memory_order_relaxed);
+	atomic_fetch_add_explicit(&p_stats->voice_sum, num_voices, memory_order_relaxed);
+	atomic_fetch_add_explicit(&p_stats->load_histogram[bucket], 1, memory_order_relaxed);
+	atomic_store_explicit(&p_stats->last_load_permille, load_permille, memory_order_relaxed);
+	atomic_store_explicit(&p_stats->num_voices, num_voices, memory_order_relaxed);
+
+	if (load_permille > atomic_load_explicit(&p_stats->max_load_permille, memory_order_relaxed)) {
+		atomic_store_explicit(&p_stats->max_load_permille, load_permille, memory_order_relaxed);
+	}
+	if (num_voices > atomic_load_explicit(&p_stats->max_voices, memory_order_relaxed)) {
+		atomic_store_explicit(&p_stats->max_voices, num_voices, memory_order_relaxed);
+	}
+	if (render_ns > period_ns) {
+		atomic_fetch_add_explicit(&p_stats->num_deadline_misses, 1, memory_order_relaxed);
+	}
+
+	return load_permille;
+}
+
+/**
+ * @brief Count the underflow / overflow flags the audio driver reported for a callback.
+ *
+ * @param p_stats
+ * @param flags RENDER_STATS_FLAG_*
+ */
+void render_stats_record_stream_flags(render_stats_t *p_stats, uint32_t flags) {
+	if (flags & RENDER_STATS_FLAG_UNDERFLOW) {
+		atomic_fetch_add_explicit(&p_stats->num_underflows, 1, memory_order_relaxed);
+	}
+	if (flags & RENDER_STATS_FLAG_OVERFLOW) {
+		atomic_fetch_add_explicit(&p_stats->num_overflows, 1, memory_order_relaxed);
+	}
+}
+
+/**
+ * @brief Read the statistics from any thread. Loads are 1.0 when rendering takes exactly the buffer period.
+ *
+ * @param p_stats
+ * @param p_snapshot
+ */
+void render_stats_get(render_stats_t *p_stats, render_stats_snapshot_t *p_snapshot) {
+	uint64_t render_ns = atomic_load_explicit(&p_stats->render_ns, memory_order_relaxed);
+	uint64_t period_ns = atomic_load_explicit(&p_stats->period_ns, memory_order_relaxed);
+	uint64_t voice_sum = atomic_load_explicit(&p_stats->voice_sum, memory_order_relaxed);
+
+	p_snapshot->num_callbacks = atomic_load_explicit(&p_stats->num_callbacks, memory_order_relaxed);
+	p_snapshot->num_frames = atomic_load_explicit(&p_stats->num_frames, memory_order_relaxed);
+	for (uint32_t i = 0; i < RENDER_STATS_NUM_LOAD_BUCKETS; i++) {
+		p_snapshot->load_histogram[i] = atomic_load_explicit(&p_stats->load_histogram[i], memory_order_relaxed);
+	}
+	p_snapshot->avg_load = period_ns > 0 ? (double) render_ns / (double) period_ns : 0.0;
+	p_snapshot->max_load = atomic_load_explicit(&p_stats->max_load_permille, memory_order_relaxed) / 1000.0;
+	p_snapshot->last_load = atomic_load_explicit(&p_stats->last_load_permille, memory_order_relaxed) / 1000.0;
+	p_snapshot->avg_voices = p_snapshot->num_callbacks > 0 ? (double) voice_sum / (double) p_snapshot->num_callbacks : 0.0;
+	p_snapshot->num_deadline_misses = atomic_load_explicit(&p_stats->num_deadline_misses, memory_order_relaxed);
+	p_snapshot->num_underflows = atomic_load_explicit(&p_stats->num_underflows, memory_order_relaxed);
+	p_snapshot->num_overflows = atomic_load_explicit(&p_stats->num_overflows, memory_order_relaxed);
+	p_snapshot->num_voices = atomic_load_explicit(&p_stats->num_voices, memory_order_relaxed);
+	p_snapshot->max_voices = atomic_load_explicit(&p_stats->max_voices, memory_order_relaxed);
+}
@@ -0,0 +1,62 @@
+//
+// Created by Tim Holzhey on 17.10.26
+//
+
+#ifndef FM_SYNTHESIZER_RENDER_STATS_H
+#define FM_SYNTHESIZER_RENDER_STATS_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+
+// Callback load (render time / buffer period) histogram, the last bucket collects everything above
+#define RENDER_STATS_LOAD_BUCKET_PERCENT	10
+#define RENDER_STATS_NUM_LOAD_BUCKETS		16
+
+#define RENDER_STATS_FLAG_UNDERFLOW			0x1
+#define RENDER_STATS_FLAG_OVERFLOW			0x2
+
+/**
+ * Real-time callback statistics. Written by the audio thread only, read by any thread without locking, every
+ * field is a relaxed atomic so readers never see torn values. A snapshot is not taken atomically as a whole.
+ */
+typedef struct {
+	atomic_uint_fast64_t num_callbacks;
+	atomic_uint_fast64_t num_frames;
+	atomic_uint_fast64_t render_ns;
+	atomic_uint_fast64_t period_ns;
+	atomic_uint_fast64_t voice_sum;
+	atomic_uint_fast64_t load_histogram[RENDER_STATS_NUM_LOAD_BUCKETS];
+	atomic_uint max_load_permille;
+	atomic_uint last_load_permille;
+	atomic_uint num_deadline_misses;
+	atomic_uint num_underflows;
+	atomic_uint num_overflows;
+	atomic_uint num_voices;
+	atomic_uint max_voices;
+} render_stats_t;
+
+typedef struct {
+	uint64_t num_callbacks;
+	uint64_t num_frames;
+	uint64_t load_histogram[RENDER_STATS_NUM_LOAD_BUCKETS];
+	double avg_load;
+	double max_load;
+	double last_load;
+	double avg_voices;
+	uint32_t num_deadline_misses;
+	uint32_t num_underflows;
+	uint32_t num_overflows;
+	uint32_t num_voices;
+	uint32_t max_voices;
+} render_stats_snapshot_t;
+
+void render_stats_init(render_stats_t *p_stats);
+
+uint32_t render_stats_record_callback(render_stats_t *p_stats, uint64_t render_ns, uint64_t period_ns,
+								  uint32_t num_frames, uint32_t num_voices);
+
+void render_stats_record_stream_flags(render_stats_t *p_stats, uint32_t flags);
+
+void render_stats_get(render_stats_t *p_stats, render_stats_snapshot_t *p_snapshot);
+
+#endif //FM_SYNTHESIZER_RENDER_STATS_H
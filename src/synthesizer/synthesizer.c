@@ -12,60 +12,409 @@
 #include "visualization.h"
 #include "config.h"
 #include "read_luts.h"
+#include "lut_generators.h"
+#include "voice.h"
+#include "render_plan.h"
+
+#if SYNTH_SIMD_AVX2
+#include <immintrin.h>
+#elif SYNTH_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+#define ALWAYS_INLINE			inline __attribute__((always_inline))
+
+#if (SYNTH_SIMD_AVX2 || SYNTH_SIMD_NEON) && (NUM_VOICES % SIMD_LANES) != 0
+#error "NUM_VOICES must be a multiple of SIMD_LANES for the SIMD operator kernel"
+#endif
+
+#if RENDER_CHUNK_VOICES > 32 || (64 % RENDER_CHUNK_VOICES) != 0
+#error "RENDER_CHUNK_VOICES must divide 64 and fit a 32 bit mask, a chunk never straddles an active_mask word"
+#endif
 
 // LUTS
+#if SYNTH_EMBED_LUTS
+#include "lut_tables.h"
+#else
 static uint32_t note_to_log_freq_table[NOTE_TO_LOG_FREQ_TABLE_SIZE];
-static uint32_t log_freq_to_phase_table[LOG_FREQ_TO_PHASE_TABLE_SIZE + 1];
 static uint16_t log_sin_table[LOG_SIN_TABLE_SIZE];
 static uint16_t exp_table[EXP_TABLE_SIZE];
 static int32_t coarse_log_mult_table[COARSE_LOG_MULT_TABLE_SIZE];
 static uint32_t fine_log_mult_table[FINE_LOG_MULT_TABLE_SIZE];
-static uint8_t algorithm_routing_table[ALGORITHM_ROUTING_TABLE_SIZE][NUM_OPERATORS];
 static uint8_t level_scale_table[LEVEL_SCALE_TABLE_SIZE];
+#if SYNTH_SIMD_AVX2 || SYNTH_SIMD_NEON
+// 32 bit copies of the 16 bit tables for gathers
+static uint32_t log_sin_table_32[LOG_SIN_TABLE_SIZE];
+static uint32_t exp_table_32[EXP_TABLE_SIZE];
+#endif
+#endif
 
+#if !(SYNTH_SIMD_AVX2 || SYNTH_SIMD_NEON)
 static int32_t get_sin_from_angle(uint32_t phase, uint16_t level);
 static uint16_t get_log_sin_from_angle(uint16_t phi);
+#endif
 static uint32_t get_oscillator_log_frequency(uint8_t midi_note, uint8_t mode, uint8_t coarse, uint8_t fine, uint8_t detune);
-static uint32_t get_phase_from_log_frequency(uint32_t log_freq);
-static uint32_t envelope_get_sample(uint8_t gate, uint8_t output_level, envelope_params_t *p_env_params, envelope_data_t *p_env_data);
+static uint32_t get_phase_from_log_frequency(const uint32_t *p_log_freq_to_phase_table, uint32_t log_freq);
+static uint32_t envelope_get_sample(uint8_t gate, const envelope_plan_t *p_env_plan, envelope_data_t *p_env_data, uint32_t num_frames);
+static void synthesizer_build_plan(synth_data_t *data, const voice_params_t *p_params, uint64_t hash, render_plan_t *p_plan);
+static void plan_update_frequency(synth_data_t *data, render_plan_t *p_plan, uint32_t operator_idx);
+
+static bool luts_loaded;
 
-synth_data_t synth_data;
+/**
+ * @brief Read the lookup tables shared by all engines, once per process. Embedded tables need no loading.
+ *
+ * @return RET_CODE_OK on success
+ */
+static ret_code_t synthesizer_load_luts(void) {
+	if (luts_loaded) {
+		return RET_CODE_OK;
+	}
 
-ret_code_t synthesizer_init(void) {
+#if !SYNTH_EMBED_LUTS
 	RET_ON_FAIL(READ_LUT("hex_u32_note_to_log_freq.mem", note_to_log_freq_table));
-	RET_ON_FAIL(READ_LUT("hex_u32_log_freq_to_phase.mem", log_freq_to_phase_table));
 	RET_ON_FAIL(READ_LUT("hex_u16_log_sin.mem", log_sin_table));
 	RET_ON_FAIL(READ_LUT("hex_u16_exp.mem", exp_table));
 	RET_ON_FAIL(READ_LUT("hex_i32_coarse_log_mult.mem", coarse_log_mult_table));
 	RET_ON_FAIL(READ_LUT("hex_u32_fine_log_mult.mem", fine_log_mult_table));
 	RET_ON_FAIL(READ_LUT("hex_u8_level_scale.mem", level_scale_table));
-	uint64_t algorithm_routing_table_raw[ALGORITHM_ROUTING_TABLE_SIZE];
-	RET_ON_FAIL(READ_LUT("hex_u64_algorithm_routing.mem", algorithm_routing_table_raw));
-	for (uint32_t i = 0; i < ALGORITHM_ROUTING_TABLE_SIZE; i++) {
-		for (uint32_t j = 0; j < NUM_OPERATORS; j++) {
-			algorithm_routing_table[i][j] = (algorithm_routing_table_raw[i] >> (j * 8)) & 0xFF;
-		}
+#if SYNTH_SIMD_AVX2 || SYNTH_SIMD_NEON
+	for (uint32_t i = 0; i < LOG_SIN_TABLE_SIZE; i++) {
+		log_sin_table_32[i] = log_sin_table[i];
+	}
+	for (uint32_t i = 0; i < EXP_TABLE_SIZE; i++) {
+		exp_table_32[i] = exp_table[i];
 	}
+#endif
+#endif
+
+	luts_loaded = true;
+	return RET_CODE_OK;
+}
+
+/**
+ * @brief Initialize an engine with the default patch and the configured worker threads.
+ *
+ * @param data engine
+ * @param sample_rate Hz, AUDIO_MIN_SAMPLE_RATE..AUDIO_MAX_SAMPLE_RATE
+ * @return RET_CODE_OK on success
+ */
+ret_code_t synthesizer_init(synth_data_t *data, uint32_t sample_rate) {
+	RET_ON_FAIL(synthesizer_init_engine(data, sample_rate));
 
 	// Load default patch file
-	RET_ON_FAIL(patch_file_load_rom(DEFAULT_PATCH_FILE));
+	RET_ON_FAIL(patch_file_load_rom(&data->patch_file, DEFAULT_PATCH_FILE));
 
 	// Load default sample
-	RET_ON_FAIL(patch_file_load_patch(DEFAULT_PATCH_FILE_VOICE - 1, &synth_data.voice_params));
+	voice_params_t voice_params;
+	RET_ON_FAIL(patch_file_load_patch(&data->patch_file, DEFAULT_PATCH_FILE_VOICE - 1, &voice_params));
+	RET_ON_FAIL(synthesizer_set_patch(data, &voice_params));
+
+#if SYNTH_WORKER_THREADS > 0
+	RET_ON_FAIL(synthesizer_start_workers(data, SYNTH_WORKER_THREADS, SYNTH_PARALLEL_MIN_VOICES));
+#endif
+
+	return RET_CODE_OK;
+}
+
+/**
+ * @brief Initialize an engine without loading a patch, e.g. one per thread of a batch renderer. The caller sets a
+ * patch with synthesizer_set_patch() before rendering. The visualization is off until
+ * data->p_visualization is set.
+ *
+ * @param data engine, zero or previously initialized
+ * @param sample_rate Hz, AUDIO_MIN_SAMPLE_RATE..AUDIO_MAX_SAMPLE_RATE
+ * @return RET_CODE_OK on success
+ */
+ret_code_t synthesizer_init_engine(synth_data_t *data, uint32_t sample_rate) {
+	RET_ON_FAIL(synthesizer_load_luts());
+	render_plan_cache_init(&data->plan_cache);
+	data->p_plan = NULL;
+	param_queue_init(&data->param_queue);
+	atomic_init(&data->param_edit_barrier, 0);
+	data->patch_edited = false;
+	RET_ON_FAIL(synthesizer_set_sample_rate(data, sample_rate));
+
+	memset(&data->voice_data, 0, sizeof(data->voice_data));
+	data->voice_allocator.steal_policy = VOICE_STEAL_POLICY_DEFAULT;
+	data->voice_allocator.voice_limit = NUM_VOICES;
+	voice_governor_init(&data->voice_governor, VOICE_GOVERNOR_ENABLE);
+	voice_init(data);
+	midi_queue_init(&data->midi_queue);
+	data->retire_level = VOICE_RETIRE_LEVEL;
+	atomic_init(&data->num_operator_samples, 0);
+	atomic_init(&data->num_operator_samples_culled, 0);
+	atomic_init(&data->num_voices_retired_early, 0);
+	data->peak_active_voices = 0;
+	render_stats_init(&data->render_stats);
+	render_profile_init(&data->render_profile);
+	data->last_callback_ns = 0;
+	data->envelope_block_frame = 0;
+	data->p_visualization = NULL;
+	patch_file_init(&data->patch_file);
+	data->parallel_min_voices = SYNTH_PARALLEL_MIN_VOICES;
+
+	return RET_CODE_OK;
+}
+
+/**
+ * @brief Compute the sample rate dependent tables of an engine and rebuild the cached render plans for them. Must
+ * not be called while the engine renders.
+ *
+ * @param data engine
+ * @param sample_rate Hz, AUDIO_MIN_SAMPLE_RATE..AUDIO_MAX_SAMPLE_RATE
+ * @return RET_CODE_OK on success, RET_CODE_ERROR if the rate is out of range
+ */
+ret_code_t synthesizer_set_sample_rate(synth_data_t *data, uint32_t sample_rate) {
+	if (sample_rate < AUDIO_MIN_SAMPLE_RATE || sample_rate > AUDIO_MAX_SAMPLE_RATE) {
+		log_error("Unsupported sample rate %u Hz.", sample_rate);
+		return RET_CODE_ERROR;
+	}
+
+	data->sample_rate = sample_rate;
+	data->envelope_rate_scale = (uint32_t) ((((uint64_t) ENVELOPE_REFERENCE_SAMPLE_RATE << ENVELOPE_RATE_SCALE_BITS) + sample_rate / 2) / sample_rate);
+	lut_generate_log_freq_to_phase(data->log_freq_to_phase_table, sample_rate);
+
+	for (uint32_t i = 0; i < RENDER_PLAN_CACHE_SIZE; i++) {
+		if (data->plan_cache.valid[i]) {
+			render_plan_t *p_plan = &data->plan_cache.plans[i];
+			synthesizer_build_plan(data, &p_plan->voice_params, p_plan->hash, p_plan);
+		}
+	}
+	if (data->p_plan == &data->edit_plan) {
+		synthesizer_build_plan(data, &data->edit_plan.voice_params, data->edit_plan.hash, &data->edit_plan);
+	}
+	if (data->p_plan != NULL) {
+		for (uint32_t voice_idx = 0; voice_idx < NUM_VOICES; voice_idx++) {
+			synthesizer_update_phase_increments(data, voice_idx);
+		}
+	}
+
+	return RET_CODE_OK;
+}
+
+/**
+ * @brief Start worker threads that render voice chunks in parallel. Output is identical for any number of threads.
+ *
+ * @param data engine
+ * @param num_threads worker threads in addition to the audio thread
+ * @param min_parallel_voices render on the audio thread only while fewer voices are active
+ * @return RET_CODE_OK on success
+ */
+ret_code_t synthesizer_start_workers(synth_data_t *data, uint32_t num_threads, uint32_t min_parallel_voices) {
+	synthesizer_stop_workers(data);
+
+	data->parallel_min_voices = min_parallel_voices;
+	if (num_threads == 0) {
+		return RET_CODE_OK;
+	}
+
+	worker_pool_t *p_worker_pool = malloc(sizeof(worker_pool_t));
+	if (p_worker_pool == NULL) {
+		log_error("Failed to allocate worker pool");
+		return RET_CODE_ERROR;
+	}
 
+	if (worker_pool_init(p_worker_pool, num_threads) != RET_CODE_OK) {
+		free(p_worker_pool);
+		return RET_CODE_ERROR;
+	}
+
+	data->p_worker_pool = p_worker_pool;
 	return RET_CODE_OK;
 }
 
+/**
+ * @brief Stop the worker threads, rendering continues on the audio thread only. Must not be called while rendering.
+ *
+ * @param data engine
+ */
+void synthesizer_stop_workers(synth_data_t *data) {
+	if (data->p_worker_pool == NULL) {
+		return;
+	}
+
+	worker_pool_deinit(data->p_worker_pool);
+	free(data->p_worker_pool);
+	data->p_worker_pool = NULL;
+}
+
+/**
+ * @brief Copy the phase increments of all operators of a voice for its note from the current render plan. Voices
+ * started before the first plan is taken are updated when it is.
+ *
+ * @param data engine
+ * @param voice_idx
+ */
+void synthesizer_update_phase_increments(synth_data_t *data, uint32_t voice_idx) {
+	if (data->p_plan == NULL) {
+		return;
+	}
+
+	RENDER_PROFILE_BEGIN(profile_timer);
+	voice_data_t *p_voice_data = &data->voice_data;
+	uint8_t note = p_voice_data->note[voice_idx] & (NUM_MIDI_NOTES - 1);
+	for (uint32_t operator_idx = 0; operator_idx < NUM_OPERATORS; operator_idx++) {
+		p_voice_data->phase_inc[operator_idx][voice_idx] = data->p_plan->phase_inc[operator_idx][note];
+	}
+	RENDER_PROFILE_LAP(profile_timer, RENDER_STAGE_FREQUENCY);
+}
+
+/**
+ * @brief Set the carrier level from which released voices are retired before their envelopes end.
+ *
+ * @param data engine
+ * @param retire_level 1..ENVELOPE_MAX, OPERATOR_SILENT_LEVEL retires only inaudible voices, 0 = off
+ */
+void synthesizer_set_retire_level(synth_data_t *data, uint16_t retire_level) {
+	data->retire_level = retire_level;
+}
+
+/**
+ * @brief Get the number of rendered and culled operator samples and of early retired voices.
+ *
+ * @param data engine
+ * @param p_counters
+ */
+void synthesizer_get_cull_counters(synth_data_t *data, synthesizer_cull_counters_t *p_counters) {
+	p_counters->num_operator_samples = atomic_load_explicit(&data->num_operator_samples, memory_order_relaxed);
+	p_counters->num_operator_samples_culled = atomic_load_explicit(&data->num_operator_samples_culled, memory_order_relaxed);
+	p_counters->num_voices_retired_early = atomic_load_explicit(&data->num_voices_retired_early, memory_order_relaxed);
+}
+
+/**
+ * @brief Timestamp a MIDI message and queue it for the audio thread. Must only be called from one (producer) thread.
+ *
+ * @param data engine
+ * @param status MIDI status byte
+ * @param data1
+ * @param data2
+ * @return RET_CODE_ERROR if the message type is not handled (note off, note on and control change are) or the queue
+ * is full. Unhandled controllers are counted as dropped on the audio thread.
+ */
+ret_code_t synthesizer_queue_midi_event(synth_data_t *data, uint8_t status, uint8_t data1, uint8_t data2) {
+	uint8_t message_type = status & 0xF0;
+	if (message_type != MIDI_STATUS_NOTE_OFF && message_type != MIDI_STATUS_NOTE_ON && message_type != MIDI_STATUS_CONTROL_CHANGE) {
+		midi_queue_count_dropped(&data->midi_queue);
+		return RET_CODE_ERROR;
+	}
+
+	midi_event_t event = {
+			.timestamp_ns = midi_queue_timestamp_now(),
+			.status = status,
+			.data1 = data1,
+			.data2 = data2,
+	};
+
+	return midi_queue_push(&data->midi_queue, &event);
+}
+
+void synthesizer_get_midi_counters(synth_data_t *data, midi_queue_counters_t *p_counters) {
+	midi_queue_get_counters(&data->midi_queue, p_counters);
+}
+
+/**
+ * @brief Get the real-time callback statistics, safe to call from any thread.
+ *
+ * @param data engine
+ * @param p_snapshot
+ */
+void synthesizer_get_render_stats(synth_data_t *data, render_stats_snapshot_t *p_snapshot) {
+	render_stats_get(&data->render_stats, p_snapshot);
+}
+
+/**
+ * @brief Get the per-stage render time by algorithm, all zero unless built with SYNTH_PROFILE_STAGES.
+ *
+ * @param data engine
+ * @param p_snapshot
+ */
+void synthesizer_get_render_profile(synth_data_t *data, render_profile_snapshot_t *p_snapshot) {
+	render_profile_get(&data->render_profile, p_snapshot);
+}
+
+/**
+ * @brief Turn the polyphony governor of the real-time stream on or off, off restores full polyphony with the next
+ * callback. Safe to call from any thread.
+ *
+ * @param data engine
+ * @param enabled
+ */
+void synthesizer_set_governor_enabled(synth_data_t *data, bool enabled) {
+	atomic_store_explicit(&data->voice_governor.enabled, enabled, memory_order_relaxed);
+}
+
+/**
+ * @brief Get the current voice limit and the governor counters, safe to call from any thread.
+ *
+ * @param data engine
+ * @param p_counters
+ */
+void synthesizer_get_governor_counters(synth_data_t *data, voice_governor_counters_t *p_counters) {
+	voice_governor_get_counters(&data->voice_governor, p_counters);
+}
+
+/**
+ * @brief Log the voice limit changes the audio thread queued since the last call. Must only be called from one
+ * (control) thread, regularly enough that the event ring does not overflow.
+ *
+ * @param data engine
+ * @return number of logged changes
+ */
+uint32_t synthesizer_log_governor_events(synth_data_t *data) {
+	uint32_t num_events = 0;
+	voice_governor_event_t event;
+	while (voice_governor_read_event(&data->voice_governor, &event)) {
+		log_info("Voice limit %u -> %u at load %.3f, %u voices freed", event.old_limit, event.new_limit,
+				 event.load_permille / 1000.0, event.num_voices_freed);
+		num_events++;
+	}
+	return num_events;
+}
+
+/**
+ * @brief Apply a queued MIDI event to the voices. Called on the audio thread.
+ *
+ * @param data
+ * @param p_event
+ */
+static void synthesizer_apply_midi_event(synth_data_t *data, const midi_event_t *p_event) {
+	switch (p_event->status & 0xF0) {
+		case MIDI_STATUS_NOTE_OFF:
+			voice_release_key(data, p_event->data1, p_event->data2);
+			break;
+		case MIDI_STATUS_NOTE_ON:
+			// Velocity 0 is a note off, Standard MIDI Files use it with running status
+			if (p_event->data2 == 0) {
+				voice_release_key(data, p_event->data1, 0);
+			} else if (voice_assign_key(data, p_event->data1, p_event->data2) != RET_CODE_OK) {
+				midi_queue_count_dropped(&data->midi_queue);
+			}
+			break;
+		case MIDI_STATUS_CONTROL_CHANGE:
+			if (p_event->data1 == MIDI_CONTROL_ALL_SOUND_OFF) {
+				voice_init(data);
+			} else {
+				midi_queue_count_dropped(&data->midi_queue);
+			}
+			break;
+		default:
+			midi_queue_count_dropped(&data->midi_queue);
+			break;
+	}
+}
+
 /**
  * @brief Get the phase increment for a given log2(frequency) value. Linearly interpolates between the two closest values in the table.
  *
+ * @param p_log_freq_to_phase_table table of the engine sample rate
  * @param log_freq
  * @return phase increment
  */
-static uint32_t get_phase_from_log_frequency(uint32_t log_freq) {
+static uint32_t get_phase_from_log_frequency(const uint32_t *p_log_freq_to_phase_table, uint32_t log_freq) {
 	uint16_t index = (log_freq & SAMPLE_MASK) >> LOG_FREQ_TO_PHASE_TABLE_SAMPLE_SHIFT;
-	uint32_t phase_low = log_freq_to_phase_table[index];
-	uint32_t phase_high = log_freq_to_phase_table[index + 1];
+	uint32_t phase_low = p_log_freq_to_phase_table[index];
+	uint32_t phase_high = p_log_freq_to_phase_table[index + 1];
 	uint32_t low_bits = log_freq & ((1 << LOG_FREQ_TO_PHASE_TABLE_SAMPLE_SHIFT) - 1);
 	uint32_t high_bits = log_freq >> SAMPLE_BIT_WIDTH;
 	uint64_t slope = (int64_t) (phase_high - phase_low) * (int64_t) low_bits;
@@ -98,6 +447,7 @@ static uint32_t get_oscillator_log_frequency(uint8_t midi_note, uint8_t mode, ui
 	return log_freq;
 }
 
+#if !(SYNTH_SIMD_AVX2 || SYNTH_SIMD_NEON)
 /**
  * @brief Get the log2(sin(phi)) value for a given angle.
  *
@@ -141,134 +491,858 @@ static int32_t get_sin_from_angle(uint32_t phase, uint16_t level) {
 
 	return is_signed ? -result << LOG_FREQ_TO_PHASE_TABLE_SAMPLE_SHIFT : result << LOG_FREQ_TO_PHASE_TABLE_SAMPLE_SHIFT;
 }
+#endif
 
 /**
- * @brief Advances the envelope state machine and returns the next level sample.
+ * @brief Advances the envelope state machine by a number of frames and returns the resulting level.
+ * With num_frames = 1 this is the exact per-sample envelope, larger values step a whole control block at once.
+ * A segment that reaches its target level stops there for the rest of the step.
  *
  * @param gate 0 = off, 1 = on
- * @param output_level 0..99 (quiet to loud)
- * @param p_env_params
+ * @param p_env_plan levels and steps of the operator
  * @param p_env_data
+ * @param num_frames 1..ENVELOPE_BLOCK_SIZE
  * @return level 0..ENVELOPE_MAX (loud to quiet)
  */
-static uint32_t envelope_get_sample(uint8_t gate, uint8_t output_level, envelope_params_t *p_env_params, envelope_data_t *p_env_data) {
+static uint32_t envelope_get_sample(uint8_t gate, const envelope_plan_t *p_env_plan, envelope_data_t *p_env_data, uint32_t num_frames) {
 	if (p_env_data->state != ENVELOPE_STATE_OFF && gate == 0) {
 		p_env_data->state = ENVELOPE_STATE_RELEASE;
 	}
 
 	if (p_env_data->state < ENVELOPE_STATE_RELEASE || (p_env_data->state == ENVELOPE_STATE_RELEASE && gate == 0)) {
-		int32_t target_level = level_scale_table[p_env_params->levels[p_env_data->state]] << 24;
-		uint32_t delta_level = ((p_env_params->rates[p_env_data->state] * ((p_env_params->rates[p_env_data->state] >> 2) + 4)) + 16) << 9;
+		int32_t target_level = p_env_plan->target_level[p_env_data->state];
 
 		if (target_level > p_env_data->level) {
-			p_env_data->level += delta_level;
-			if (p_env_data->level > target_level) {
+			int64_t level = (int64_t) p_env_data->level + p_env_plan->rise_step[p_env_data->state] * num_frames;
+			if (level > target_level) {
 				p_env_data->level = target_level;
 				p_env_data->state++;
+			} else {
+				p_env_data->level = (int32_t) level;
 			}
 		} else {
-			p_env_data->level -= (delta_level >> 11) * (delta_level >> 11);
-			if (p_env_data->level < target_level) {
+			int64_t level = (int64_t) p_env_data->level - p_env_plan->fall_step[p_env_data->state] * num_frames;
+			if (level < target_level) {
 				p_env_data->level = target_level;
 				p_env_data->state++;
+			} else {
+				p_env_data->level = (int32_t) level;
 			}
 		}
 	}
 
-	return ((((p_env_data->level >> 24) + 1) * (level_scale_table[output_level] + 1)) >> 5) - 1;
+	return ((((p_env_data->level >> 24) + 1) * p_env_plan->output_scale) >> 5) - 1;
+}
+
+#if ENVELOPE_BLOCK_SIZE > 1
+/**
+ * @brief Get the operator level for the current frame from the block-rate envelope.
+ * The envelope state machine is only stepped on control block boundaries, in between the level is
+ * ramped linearly from the previous block end level to the new one.
+ *
+ * @param gate 0 = off, 1 = on
+ * @param block_frame 0..ENVELOPE_BLOCK_SIZE - 1
+ * @param p_env_plan levels and steps of the operator
+ * @param p_env_data
+ * @return level 0..ENVELOPE_MAX (loud to quiet)
+ */
+static uint32_t envelope_get_block_sample(uint8_t gate, uint32_t block_frame, const envelope_plan_t *p_env_plan, envelope_data_t *p_env_data) {
+	if (block_frame == 0) {
+		int32_t block_end_level = (int32_t) envelope_get_sample(gate, p_env_plan, p_env_data, ENVELOPE_BLOCK_SIZE);
+		// The end level is -1 for the loudest output levels, multiply instead of shifting a negative value
+		p_env_data->ramp_step = ((block_end_level * (1 << ENVELOPE_RAMP_FRACTION_BITS)) - p_env_data->ramp_level) / ENVELOPE_BLOCK_SIZE;
+	}
+
+	p_env_data->ramp_level += p_env_data->ramp_step;
+
+	return (uint32_t) (p_env_data->ramp_level >> ENVELOPE_RAMP_FRACTION_BITS);
 }
+#endif
 
-int synthesizer_render(const void *input_buffer, void *output_buffer,
-					   unsigned long frames_per_buffer,
-					   const PaStreamCallbackTimeInfo *time_info,
-					   PaStreamCallbackFlags status_flags,
-					   void *user_data) {
-	synth_data_t *data = (synth_data_t *) user_data;
-	int32_t *out = (int32_t *) output_buffer;
+#if SYNTH_SIMD_AVX2
+/**
+ * @brief Vectorized get_sin_from_angle() for 8 voices, bit-identical to the scalar version.
+ *
+ * @param phase
+ * @param level 0..ENVELOPE_MAX (loud to quiet)
+ * @return sin values
+ */
+static inline __m256i get_sin_from_angle_x8(__m256i phase, __m256i level) {
+	__m256i phi = _mm256_srli_epi32(phase, LOG_FREQ_TO_PHASE_TABLE_SAMPLE_SHIFT);
+	__m256i index = _mm256_and_si256(phi, _mm256_set1_epi32(LOG_SIN_TABLE_MASK));
+	__m256i mirror = _mm256_cmpeq_epi32(_mm256_and_si256(phi, _mm256_set1_epi32(1 << LOG_SIN_TABLE_BIT_WIDTH)), _mm256_set1_epi32(1 << LOG_SIN_TABLE_BIT_WIDTH));
+	index = _mm256_xor_si256(index, _mm256_and_si256(mirror, _mm256_set1_epi32(LOG_SIN_TABLE_SIZE - 1)));
+	__m256i sign = _mm256_and_si256(_mm256_slli_epi32(phi, 15 - (LOG_SIN_TABLE_BIT_WIDTH + 1)), _mm256_set1_epi32(INT16_SIGN_BIT));
 
-	(void) time_info;
-	(void) status_flags;
-	(void) input_buffer;
+	// log2(sin(phi)) + level
+	__m256i log_sin = _mm256_i32gather_epi32((const int *) log_sin_table_32, index, 4);
+	log_sin = _mm256_add_epi32(_mm256_or_si256(log_sin, sign), _mm256_slli_epi32(level, ENVELOPE_BIT_WIDTH - 6));
+	log_sin = _mm256_and_si256(log_sin, _mm256_set1_epi32(0xFFFF));
 
-	for (uint32_t frame_idx = 0; frame_idx < frames_per_buffer; frame_idx++) {
-		int32_t master_buffer = 0;
+	__m256i is_signed = _mm256_cmpeq_epi32(_mm256_and_si256(log_sin, _mm256_set1_epi32(INT16_SIGN_BIT)), _mm256_set1_epi32(INT16_SIGN_BIT));
+	log_sin = _mm256_and_si256(log_sin, _mm256_set1_epi32(~INT16_SIGN_BIT & 0xFFFF));
 
-		for (uint32_t voice_idx = 0; voice_idx < NUM_VOICES; voice_idx++) {
-			if (data->voice_data[voice_idx].enable == 0) {
-				continue;
+	// 2^(log2(sin(phi)) + level)
+	__m256i exp_index = _mm256_xor_si256(_mm256_and_si256(log_sin, _mm256_set1_epi32(EXP_TABLE_SIZE - 1)), _mm256_set1_epi32(EXP_TABLE_SIZE - 1));
+	__m256i result = _mm256_add_epi32(_mm256_i32gather_epi32((const int *) exp_table_32, exp_index, 4), _mm256_set1_epi32(1 << EXP_TABLE_BIT_WIDTH));
+	result = _mm256_slli_epi32(result, 1);
+	result = _mm256_srlv_epi32(result, _mm256_srli_epi32(log_sin, EXP_TABLE_LOG_SIZE));
+
+	result = _mm256_blendv_epi8(result, _mm256_sub_epi32(_mm256_setzero_si256(), result), is_signed);
+	return _mm256_slli_epi32(result, LOG_FREQ_TO_PHASE_TABLE_SAMPLE_SHIFT);
+}
+#elif SYNTH_SIMD_NEON
+/**
+ * @brief Vectorized get_sin_from_angle() for 4 voices, bit-identical to the scalar version.
+ * NEON has no gather instruction, the table lookups are done per lane.
+ *
+ * @param phase
+ * @param level 0..ENVELOPE_MAX (loud to quiet)
+ * @return sin values
+ */
+static inline int32x4_t get_sin_from_angle_x4(uint32x4_t phase, uint32x4_t level) {
+	uint32x4_t phi = vshrq_n_u32(phase, LOG_FREQ_TO_PHASE_TABLE_SAMPLE_SHIFT);
+	uint32x4_t index = vandq_u32(phi, vdupq_n_u32(LOG_SIN_TABLE_MASK));
+	uint32x4_t mirror = vtstq_u32(phi, vdupq_n_u32(1 << LOG_SIN_TABLE_BIT_WIDTH));
+	index = veorq_u32(index, vandq_u32(mirror, vdupq_n_u32(LOG_SIN_TABLE_SIZE - 1)));
+	uint32x4_t sign = vandq_u32(vshlq_n_u32(phi, 15 - (LOG_SIN_TABLE_BIT_WIDTH + 1)), vdupq_n_u32(INT16_SIGN_BIT));
+
+	// log2(sin(phi)) + level
+	uint32x4_t log_sin = vdupq_n_u32(0);
+	log_sin = vsetq_lane_u32(log_sin_table_32[vgetq_lane_u32(index, 0)], log_sin, 0);
+	log_sin = vsetq_lane_u32(log_sin_table_32[vgetq_lane_u32(index, 1)], log_sin, 1);
+	log_sin = vsetq_lane_u32(log_sin_table_32[vgetq_lane_u32(index, 2)], log_sin, 2);
+	log_sin = vsetq_lane_u32(log_sin_table_32[vgetq_lane_u32(index, 3)], log_sin, 3);
+	log_sin = vaddq_u32(vorrq_u32(log_sin, sign), vshlq_n_u32(level, ENVELOPE_BIT_WIDTH - 6));
+	log_sin = vandq_u32(log_sin, vdupq_n_u32(0xFFFF));
+
+	uint32x4_t is_signed = vtstq_u32(log_sin, vdupq_n_u32(INT16_SIGN_BIT));
+	log_sin = vandq_u32(log_sin, vdupq_n_u32(~INT16_SIGN_BIT & 0xFFFF));
+
+	// 2^(log2(sin(phi)) + level)
+	uint32x4_t exp_index = veorq_u32(vandq_u32(log_sin, vdupq_n_u32(EXP_TABLE_SIZE - 1)), vdupq_n_u32(EXP_TABLE_SIZE - 1));
+	uint32x4_t result = vdupq_n_u32(0);
+	result = vsetq_lane_u32(exp_table_32[vgetq_lane_u32(exp_index, 0)], result, 0);
+	result = vsetq_lane_u32(exp_table_32[vgetq_lane_u32(exp_index, 1)], result, 1);
+	result = vsetq_lane_u32(exp_table_32[vgetq_lane_u32(exp_index, 2)], result, 2);
+	result = vsetq_lane_u32(exp_table_32[vgetq_lane_u32(exp_index, 3)], result, 3);
+	result = vaddq_u32(result, vdupq_n_u32(1 << EXP_TABLE_BIT_WIDTH));
+	result = vshlq_n_u32(result, 1);
+	// shift right by (log_sin >> EXP_TABLE_LOG_SIZE): negative left shift
+	result = vshlq_u32(result, vnegq_s32(vreinterpretq_s32_u32(vshrq_n_u32(log_sin, EXP_TABLE_LOG_SIZE))));
+
+	int32x4_t signed_result = vreinterpretq_s32_u32(result);
+	signed_result = vbslq_s32(is_signed, vnegq_s32(signed_result), signed_result);
+	return vshlq_n_s32(signed_result, LOG_FREQ_TO_PHASE_TABLE_SAMPLE_SHIFT);
+}
+#endif
+
+/**
+ * @brief Get the active_mask bits of a voice range.
+ *
+ * @param p_voice_data
+ * @param voice_start first voice of the range
+ * @param voice_end one past the last voice of the range, at most 32 voices within one mask word
+ * @return bit i set if voice voice_start + i is enabled
+ */
+static ALWAYS_INLINE uint32_t voice_range_mask(const voice_data_t *p_voice_data, uint32_t voice_start, uint32_t voice_end) {
+	uint64_t word = p_voice_data->active_mask[voice_start >> 6] >> (voice_start & 63);
+	uint32_t num_voices = voice_end - voice_start;
+	return (uint32_t) (num_voices >= 32 ? word : word & ((1ULL << num_voices) - 1));
+}
+
+/**
+ * @brief Reset the modulation input of an operator of a voice range at the start of a frame.
+ *
+ * @param p_voice_data
+ * @param operator_idx 0..NUM_OPERATORS - 1
+ * @param voice_start first voice of the range
+ * @param voice_end one past the last voice of the range
+ */
+static ALWAYS_INLINE void operator_clear_input(voice_data_t *p_voice_data, uint32_t operator_idx, uint32_t voice_start, uint32_t voice_end) {
+	RENDER_PROFILE_BEGIN(profile_timer);
+	memset(&p_voice_data->input_mod_buffer[operator_idx][voice_start], 0, (voice_end - voice_start) * sizeof(int32_t));
+	RENDER_PROFILE_LAP(profile_timer, RENDER_STAGE_ROUTING);
+}
+
+/**
+ * @brief Set the modulation input of the feedback operator of a voice range from their feedback buffer.
+ *
+ * @param p_voice_data
+ * @param operator_idx 0..NUM_OPERATORS - 1
+ * @param feedback_shift
+ * @param voice_start first voice of the range
+ * @param voice_end one past the last voice of the range
+ */
+static ALWAYS_INLINE void operator_feedback_input(voice_data_t *p_voice_data, uint32_t operator_idx, uint8_t feedback_shift, uint32_t voice_start, uint32_t voice_end) {
+	RENDER_PROFILE_BEGIN(profile_timer);
+	for (uint32_t voice_idx = voice_start; voice_idx < voice_end; voice_idx++) {
+		p_voice_data->input_mod_buffer[operator_idx][voice_idx] = p_voice_data->feedback_buffer[voice_idx] >> feedback_shift;
+	}
+	RENDER_PROFILE_LAP(profile_timer, RENDER_STAGE_ROUTING);
+}
+
+/**
+ * @brief Sample one operator of the active voices of a range, advance their phases and route the samples.
+ * Only called from the generated algorithm kernels with constant routing, so all routing branches fold away.
+ *
+ * @param p_voice_data
+ * @param voice_start first voice of the range, multiple of SIMD_LANES for the SIMD kernel
+ * @param voice_end one past the last voice of the range
+ * @param operator_idx 0..NUM_OPERATORS - 1
+ * @param mod_outputs OUTPUT_MODE_INDEX_x mask of the modulated operators
+ * @param carrier route to the master output
+ * @param feedback route to the feedback buffer
+ * @return sum of the samples routed to the master output
+ */
+static ALWAYS_INLINE int32_t operator_sample_voices(voice_data_t *p_voice_data, uint32_t voice_start, uint32_t voice_end, uint32_t operator_idx, uint8_t mod_outputs, bool carrier, bool feedback) {
+	int32_t master_buffer = 0;
+	RENDER_PROFILE_BEGIN(profile_timer);
+
+#if SYNTH_SIMD_AVX2
+	uint32_t voice_mask = voice_range_mask(p_voice_data, voice_start, voice_end);
+	const __m256i lane_bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+	__m256i master_vec = _mm256_setzero_si256();
+	for (uint32_t voice_idx = voice_start; voice_idx < voice_end; voice_idx += SIMD_LANES) {
+		uint32_t lane_mask = (voice_mask >> (voice_idx - voice_start)) & 0xFF;
+		if (lane_mask == 0) {
+			continue;
+		}
+		__m256i enable = _mm256_and_si256(_mm256_set1_epi32((int32_t) lane_mask), lane_bits);
+		enable = _mm256_cmpeq_epi32(enable, lane_bits);
+
+		__m256i *p_phase = (__m256i *) &p_voice_data->phase[operator_idx][voice_idx];
+		__m256i phase = _mm256_loadu_si256(p_phase);
+		__m256i level = _mm256_loadu_si256((const __m256i *) &p_voice_data->level[operator_idx][voice_idx]);
+		__m256i phase_inc = _mm256_loadu_si256((const __m256i *) &p_voice_data->phase_inc[operator_idx][voice_idx]);
+
+		// All lanes silent: every sample is 0, only the phases and the feedback buffer change
+		__m256i audible = _mm256_and_si256(enable, _mm256_cmpgt_epi32(_mm256_set1_epi32(OPERATOR_SILENT_LEVEL), level));
+		if (_mm256_testz_si256(audible, audible)) {
+			_mm256_storeu_si256(p_phase, _mm256_add_epi32(phase, _mm256_and_si256(phase_inc, enable)));
+			if (feedback) {
+				__m256i *p_feedback = (__m256i *) &p_voice_data->feedback_buffer[voice_idx];
+				_mm256_storeu_si256(p_feedback, _mm256_andnot_si256(enable, _mm256_loadu_si256(p_feedback)));
 			}
+			RENDER_PROFILE_LAP(profile_timer, RENDER_STAGE_ROUTING);
+			continue;
+		}
 
-			const uint8_t *routing = algorithm_routing_table[data->voice_params.algorithm];
+		__m256i input_mod = _mm256_loadu_si256((const __m256i *) &p_voice_data->input_mod_buffer[operator_idx][voice_idx]);
 
-			// Init input buffers
-			for (uint32_t operator_idx = 0; operator_idx < NUM_OPERATORS; operator_idx++) {
-				operator_data_t *op_data = &data->voice_data[voice_idx].operator_data[operator_idx];
-				op_data->input_mod_buffer = 0;
-				if (routing[operator_idx] & (1 << operator_idx)) {
-					op_data->input_mod_buffer = data->voice_data[voice_idx].feedback_buffer >> (FEEDBACK_BIT_WIDTH - data->voice_params.feedback + 1);
-				}
+		// Sample sine wave
+		__m256i sample = get_sin_from_angle_x8(_mm256_add_epi32(phase, input_mod), level);
+		sample = _mm256_and_si256(sample, enable);
+		RENDER_PROFILE_LAP(profile_timer, RENDER_STAGE_LOOKUP);
+
+		// Increment phase
+		_mm256_storeu_si256(p_phase, _mm256_add_epi32(phase, _mm256_and_si256(phase_inc, enable)));
+
+		// Route to master buffer
+		if (carrier) {
+			master_vec = _mm256_add_epi32(master_vec, sample);
+		}
+
+		// Route to feedback buffer
+		if (feedback) {
+			__m256i *p_feedback = (__m256i *) &p_voice_data->feedback_buffer[voice_idx];
+			_mm256_storeu_si256(p_feedback, _mm256_blendv_epi8(_mm256_loadu_si256(p_feedback), sample, enable));
+		}
+
+		// Route to other operators
+		__m256i mod_out = _mm256_srai_epi32(_mm256_mullo_epi32(sample, _mm256_set1_epi32(100)), 7);
+		for (uint8_t output_index = 0; output_index < NUM_OPERATORS; output_index++) {
+			if (mod_outputs & (1 << output_index)) {
+				__m256i *p_input_mod = (__m256i *) &p_voice_data->input_mod_buffer[output_index][voice_idx];
+				_mm256_storeu_si256(p_input_mod, _mm256_add_epi32(_mm256_loadu_si256(p_input_mod), mod_out));
 			}
+		}
+		RENDER_PROFILE_LAP(profile_timer, RENDER_STAGE_ROUTING);
+	}
+
+	__m128i master_sum = _mm_add_epi32(_mm256_castsi256_si128(master_vec), _mm256_extracti128_si256(master_vec, 1));
+	master_sum = _mm_hadd_epi32(master_sum, master_sum);
+	master_sum = _mm_hadd_epi32(master_sum, master_sum);
+	master_buffer = _mm_cvtsi128_si32(master_sum);
+#elif SYNTH_SIMD_NEON
+	uint32_t voice_mask = voice_range_mask(p_voice_data, voice_start, voice_end);
+	static const uint32_t lane_bits_array[4] = {1, 2, 4, 8};
+	const uint32x4_t lane_bits = vld1q_u32(lane_bits_array);
+	int32x4_t master_vec = vdupq_n_s32(0);
+	for (uint32_t voice_idx = voice_start; voice_idx < voice_end; voice_idx += 4) {
+		uint32_t lane_mask = (voice_mask >> (voice_idx - voice_start)) & 0xF;
+		if (lane_mask == 0) {
+			continue;
+		}
+		uint32x4_t enable = vtstq_u32(vdupq_n_u32(lane_mask), lane_bits);
+
+		uint32_t *p_phase = &p_voice_data->phase[operator_idx][voice_idx];
+		uint32x4_t phase = vld1q_u32(p_phase);
+		uint32x4_t level = vld1q_u32(&p_voice_data->level[operator_idx][voice_idx]);
+		uint32x4_t phase_inc = vld1q_u32(&p_voice_data->phase_inc[operator_idx][voice_idx]);
+
+		// All lanes silent: every sample is 0, only the phases and the feedback buffer change
+		uint32x4_t audible = vandq_u32(enable, vcltq_u32(level, vdupq_n_u32(OPERATOR_SILENT_LEVEL)));
+		if (vmaxvq_u32(audible) == 0) {
+			vst1q_u32(p_phase, vaddq_u32(phase, vandq_u32(phase_inc, enable)));
+			if (feedback) {
+				int32_t *p_feedback = &p_voice_data->feedback_buffer[voice_idx];
+				vst1q_s32(p_feedback, vbslq_s32(enable, vdupq_n_s32(0), vld1q_s32(p_feedback)));
+			}
+			RENDER_PROFILE_LAP(profile_timer, RENDER_STAGE_ROUTING);
+			continue;
+		}
+
+		uint32x4_t input_mod = vreinterpretq_u32_s32(vld1q_s32(&p_voice_data->input_mod_buffer[operator_idx][voice_idx]));
+
+		// Sample sine wave
+		int32x4_t sample = get_sin_from_angle_x4(vaddq_u32(phase, input_mod), level);
+		sample = vandq_s32(sample, vreinterpretq_s32_u32(enable));
+		RENDER_PROFILE_LAP(profile_timer, RENDER_STAGE_LOOKUP);
+
+		// Increment phase
+		vst1q_u32(p_phase, vaddq_u32(phase, vandq_u32(phase_inc, enable)));
+
+		// Route to master buffer
+		if (carrier) {
+			master_vec = vaddq_s32(master_vec, sample);
+		}
+
+		// Route to feedback buffer
+		if (feedback) {
+			int32_t *p_feedback = &p_voice_data->feedback_buffer[voice_idx];
+			vst1q_s32(p_feedback, vbslq_s32(enable, sample, vld1q_s32(p_feedback)));
+		}
+
+		// Route to other operators
+		int32x4_t mod_out = vshrq_n_s32(vmulq_n_s32(sample, 100), 7);
+		for (uint8_t output_index = 0; output_index < NUM_OPERATORS; output_index++) {
+			if (mod_outputs & (1 << output_index)) {
+				int32_t *p_input_mod = &p_voice_data->input_mod_buffer[output_index][voice_idx];
+				vst1q_s32(p_input_mod, vaddq_s32(vld1q_s32(p_input_mod), mod_out));
+			}
+		}
+		RENDER_PROFILE_LAP(profile_timer, RENDER_STAGE_ROUTING);
+	}
+
+	master_buffer = vaddvq_s32(master_vec);
+#else
+	for (uint32_t voice_mask = voice_range_mask(p_voice_data, voice_start, voice_end); voice_mask != 0; voice_mask &= voice_mask - 1) {
+		uint32_t voice_idx = voice_start + __builtin_ctz(voice_mask);
+
+		// Silent operator: the sample is 0, only the phase and the feedback buffer change
+		if (p_voice_data->level[operator_idx][voice_idx] >= OPERATOR_SILENT_LEVEL) {
+			p_voice_data->phase[operator_idx][voice_idx] += p_voice_data->phase_inc[operator_idx][voice_idx];
+			if (feedback) {
+				p_voice_data->feedback_buffer[voice_idx] = 0;
+			}
+			RENDER_PROFILE_LAP(profile_timer, RENDER_STAGE_ROUTING);
+			continue;
+		}
+
+		// Sample sine wave
+		int32_t sample = get_sin_from_angle(p_voice_data->phase[operator_idx][voice_idx] + p_voice_data->input_mod_buffer[operator_idx][voice_idx],
+											p_voice_data->level[operator_idx][voice_idx]);
+		RENDER_PROFILE_LAP(profile_timer, RENDER_STAGE_LOOKUP);
+
+		// Increment phase
+		p_voice_data->phase[operator_idx][voice_idx] += p_voice_data->phase_inc[operator_idx][voice_idx];
 
-			// Sample operators
-			for (int32_t operator_idx = NUM_OPERATORS - 1; operator_idx >= 0; operator_idx--) {
-				operator_data_t *op_data = &data->voice_data[voice_idx].operator_data[operator_idx];
-				operator_params_t *op_params = &data->voice_params.operators[operator_idx];
+		// Route to master buffer
+		if (carrier) {
+			master_buffer += sample;
+		}
+
+		// Route to feedback buffer
+		if (feedback) {
+			p_voice_data->feedback_buffer[voice_idx] = sample;
+		}
+
+		// Route to other operators
+		for (uint8_t output_index = 0; output_index < NUM_OPERATORS; output_index++) {
+			if (mod_outputs & (1 << output_index)) {
+				p_voice_data->input_mod_buffer[output_index][voice_idx] += (sample * 100) >> 7;
+			}
+		}
+		RENDER_PROFILE_LAP(profile_timer, RENDER_STAGE_ROUTING);
+	}
+#endif
+
+	return master_buffer;
+}
+
+#include "algorithm_kernels.h"
+
+/**
+ * @brief Render data->chunk_num_frames frames of one voice chunk into its mix buffer. Voices only depend on
+ * their own state, so chunks can run on any thread in any order.
+ *
+ * @param p_context engine
+ * @param chunk_idx 0..NUM_RENDER_CHUNKS - 1
+ */
+static void synthesizer_render_chunk(void *p_context, uint32_t chunk_idx) {
+	synth_data_t *data = p_context;
+	voice_data_t *p_voice_data = &data->voice_data;
+	const render_plan_t *p_plan = data->p_plan;
+	uint8_t feedback_shift = p_plan->feedback_shift;
+	uint32_t voice_start = chunk_idx * RENDER_CHUNK_VOICES;
+	uint32_t voice_end = voice_start + RENDER_CHUNK_VOICES < NUM_VOICES ? voice_start + RENDER_CHUNK_VOICES : NUM_VOICES;
+	uint32_t num_frames = data->chunk_num_frames;
+	int32_t *p_mix = data->chunk_mix[chunk_idx];
+	uint32_t envelope_block_frame = data->envelope_block_frame;
+	uint32_t num_culled = 0;
+
+	// Voices are only started and retired between blocks
+	uint32_t chunk_mask = voice_range_mask(p_voice_data, voice_start, voice_end);
+	if (chunk_mask == 0) {
+		memset(p_mix, 0, num_frames * sizeof(int32_t));
+		data->chunk_num_culled[chunk_idx] = 0;
+		return;
+	}
+
+	for (uint32_t frame_idx = 0; frame_idx < num_frames; frame_idx++) {
+		RENDER_PROFILE_BEGIN(profile_timer);
+		for (uint32_t voice_mask = chunk_mask; voice_mask != 0; voice_mask &= voice_mask - 1) {
+			uint32_t voice_idx = voice_start + __builtin_ctz(voice_mask);
 
-				// Get frequency and phase increment
-				uint32_t log_freq = get_oscillator_log_frequency(data->voice_data[voice_idx].note, op_params->osc.mode, op_params->osc.frequency_coarse, op_params->osc.frequency_fine, op_params->osc.detune);
-				uint32_t phase_inc = get_phase_from_log_frequency(log_freq);
+			for (uint32_t operator_idx = 0; operator_idx < NUM_OPERATORS; operator_idx++) {
+				const envelope_plan_t *p_env_plan = &p_plan->envelope[operator_idx];
+				envelope_data_t *p_env_data = &p_voice_data->envelope_data[operator_idx][voice_idx];
 
 				// Get level
-				uint16_t op_level = ENVELOPE_MAX - envelope_get_sample(data->voice_data[voice_idx].gate,
-																	   op_params->output_level,
-																	   &op_params->env, &op_data->envelope_data);
-
-				// Sample sine wave
-				int32_t sample = get_sin_from_angle(op_data->phase + op_data->input_mod_buffer, op_level);
-
-				// Increment phase
-				op_data->phase += phase_inc;
-
-				// Route to master buffer
-				if (routing[operator_idx] & OUTPUT_MOD_INDEX_MASTER) {
-					master_buffer += sample;
-				}
-
-				// Route to feedback buffer
-				if (routing[operator_idx] & (1 << operator_idx)) {
-					data->voice_data[voice_idx].feedback_buffer = sample;
-				}
-
-				// Route to other operators
-				for (uint8_t output_index = 0; output_index < NUM_OPERATORS; output_index++) {
-					if (routing[operator_idx] & (1 << output_index)) {
-						data->voice_data[voice_idx].operator_data[output_index].input_mod_buffer += (sample * 100) >> 7;
-					}
-				}
+#if ENVELOPE_BLOCK_SIZE > 1
+				uint16_t op_level = ENVELOPE_MAX - envelope_get_block_sample(p_voice_data->gate[voice_idx],
+																			 envelope_block_frame, p_env_plan, p_env_data);
+#else
+				uint16_t op_level = ENVELOPE_MAX - envelope_get_sample(p_voice_data->gate[voice_idx],
+																	   p_env_plan, p_env_data, 1);
+#endif
+				p_voice_data->level[operator_idx][voice_idx] = op_level;
+				num_culled += op_level >= OPERATOR_SILENT_LEVEL;
 			}
 		}
 
-		// Find lower midi note playing
-		uint8_t lowest_note = 127;
-		for (uint32_t voice_idx = 0; voice_idx < NUM_VOICES; voice_idx++) {
-			if (data->voice_data[voice_idx].gate == 0) {
-				continue;
+		RENDER_PROFILE_LAP(profile_timer, RENDER_STAGE_ENVELOPE);
+
+		// Sample operators
+		p_mix[frame_idx] = p_plan->algorithm_kernel(p_voice_data, feedback_shift, voice_start, voice_end);
+
+		// Advance envelope control block
+		if (++envelope_block_frame >= ENVELOPE_BLOCK_SIZE) {
+			envelope_block_frame = 0;
+		}
+	}
+
+	data->chunk_num_culled[chunk_idx] = num_culled;
+	render_profile_flush(&data->render_profile, p_plan->voice_params.algorithm, 0);
+}
+
+/**
+ * @brief Render a number of frames without applying any events.
+ *
+ * @param data
+ * @param out interleaved stereo output
+ * @param num_frames
+ */
+static void synthesizer_render_block(synth_data_t *data, int32_t *out, uint32_t num_frames) {
+	voice_data_t *p_voice_data = &data->voice_data;
+	voice_allocator_t *p_alloc = &data->voice_allocator;
+
+	// Find lower midi note playing, gates only change between blocks
+	uint8_t lowest_note = 127;
+	for (uint16_t voice_idx = p_alloc->list_head[VOICE_LIST_ACTIVE]; voice_idx != VOICE_NONE; voice_idx = p_alloc->list_next[voice_idx]) {
+		if (p_voice_data->note[voice_idx] < lowest_note) {
+			lowest_note = p_voice_data->note[voice_idx];
+		}
+	}
+
+	while (num_frames > 0) {
+		uint32_t num_active_voices = 0;
+		for (uint32_t word_idx = 0; word_idx < VOICE_MASK_WORDS; word_idx++) {
+			num_active_voices += __builtin_popcountll(p_voice_data->active_mask[word_idx]);
+		}
+		data->peak_active_voices = num_active_voices > data->peak_active_voices ? num_active_voices : data->peak_active_voices;
+		bool parallel = data->p_worker_pool != NULL && num_active_voices >= data->parallel_min_voices;
+
+		data->chunk_num_frames = num_frames < RENDER_BLOCK_FRAMES ? num_frames : RENDER_BLOCK_FRAMES;
+
+		// Render voice chunks
+		if (parallel) {
+			worker_pool_run(data->p_worker_pool, synthesizer_render_chunk, data, NUM_RENDER_CHUNKS);
+		} else {
+			for (uint32_t chunk_idx = 0; chunk_idx < NUM_RENDER_CHUNKS; chunk_idx++) {
+				synthesizer_render_chunk(data, chunk_idx);
+			}
+		}
+		data->envelope_block_frame = (data->envelope_block_frame + data->chunk_num_frames) % ENVELOPE_BLOCK_SIZE;
+
+		uint32_t num_culled = 0;
+		for (uint32_t chunk_idx = 0; chunk_idx < NUM_RENDER_CHUNKS; chunk_idx++) {
+			num_culled += data->chunk_num_culled[chunk_idx];
+		}
+		atomic_fetch_add_explicit(&data->num_operator_samples, (uint64_t) num_active_voices * NUM_OPERATORS * data->chunk_num_frames, memory_order_relaxed);
+		atomic_fetch_add_explicit(&data->num_operator_samples_culled, num_culled, memory_order_relaxed);
+
+		// Retire finished voices so the next block skips them
+		voice_update(data);
+
+		for (uint32_t frame_idx = 0; frame_idx < data->chunk_num_frames; frame_idx++) {
+			// Sum chunk mixes in fixed order
+			int32_t master_buffer = 0;
+			for (uint32_t chunk_idx = 0; chunk_idx < NUM_RENDER_CHUNKS; chunk_idx++) {
+				master_buffer += data->chunk_mix[chunk_idx][frame_idx];
 			}
-			if (data->voice_data[voice_idx].note < lowest_note) {
-				lowest_note = data->voice_data[voice_idx].note;
+
+			// Add sample to visualization, align with midi frequency
+			if (data->p_visualization != NULL) {
+				RENDER_PROFILE_BEGIN(profile_timer);
+				visualization_add_sample(data->p_visualization, master_buffer, lowest_note);
+				RENDER_PROFILE_LAP(profile_timer, RENDER_STAGE_VISUALIZATION);
 			}
+
+			// Amplify
+			master_buffer <<= 1;
+
+			// Write mono to stereo output buffer
+			*out++ = master_buffer;
+			*out++ = master_buffer;
 		}
 
-		// Add sample to visualization, align with midi frequency
-		visualization_add_sample(master_buffer, lowest_note);
+		render_profile_flush(&data->render_profile, data->p_plan->voice_params.algorithm, data->chunk_num_frames);
+		num_frames -= data->chunk_num_frames;
+	}
+}
+
+/**
+ * @brief Get the frame of the current buffer a MIDI event is applied at. Events are delayed by one buffer period:
+ * an event that arrived x ns into the previous callback period is applied x ns into the current buffer.
+ *
+ * @param p_event
+ * @param period_start_ns start of the previous callback period
+ * @param sample_rate Hz
+ * @param num_frames frames in the current buffer
+ * @return 0..num_frames - 1
+ */
+static uint32_t midi_event_get_frame(const midi_event_t *p_event, uint64_t period_start_ns, uint32_t sample_rate, uint32_t num_frames) {
+	if (p_event->timestamp_ns <= period_start_ns) {
+		return 0;
+	}
+
+	uint64_t event_frame = (p_event->timestamp_ns - period_start_ns) * sample_rate / 1000000000ULL;
+	return event_frame < num_frames ? (uint32_t) event_frame : num_frames - 1;
+}
+
+/**
+ * @brief Compute the algorithm kernel, carrier mask and feedback shift of a plan from its parameters.
+ *
+ * @param p_plan
+ */
+static void plan_update_routing(render_plan_t *p_plan) {
+	// The routing table has no entry for the last algorithm index, which has the same routing as the last entry
+	uint8_t algorithm = p_plan->voice_params.algorithm;
+	uint8_t routing_idx = algorithm < ALGORITHM_ROUTING_TABLE_SIZE ? algorithm : ALGORITHM_ROUTING_TABLE_SIZE - 1;
+	p_plan->algorithm_kernel = algorithm_kernels[routing_idx];
+	p_plan->carrier_mask = algorithm_carrier_masks[routing_idx];
+	p_plan->feedback_shift = FEEDBACK_BIT_WIDTH - p_plan->voice_params.feedback + 1;
+}
+
+/**
+ * @brief Compute the envelope levels and steps of one operator of a plan at the engine sample rate.
+ *
+ * @param data engine
+ * @param p_plan
+ * @param operator_idx 0..NUM_OPERATORS - 1
+ */
+static void plan_update_envelope(synth_data_t *data, render_plan_t *p_plan, uint32_t operator_idx) {
+	const operator_params_t *p_op_params = &p_plan->voice_params.operators[operator_idx];
+	envelope_plan_t *p_env_plan = &p_plan->envelope[operator_idx];
 
-		// Amplify
-		master_buffer <<= 1;
+	for (uint32_t state = 0; state < ENVELOPE_STATE_OFF; state++) {
+		uint8_t rate = p_op_params->env.rates[state];
+		uint32_t delta_level = ((rate * ((rate >> 2) + 4)) + 16) << 9;
+		p_env_plan->target_level[state] = level_scale_table[p_op_params->env.levels[state]] << 24;
+		p_env_plan->rise_step[state] = ((int64_t) delta_level * data->envelope_rate_scale) >> ENVELOPE_RATE_SCALE_BITS;
+		p_env_plan->fall_step[state] = ((int64_t) ((delta_level >> 11) * (delta_level >> 11)) * data->envelope_rate_scale) >> ENVELOPE_RATE_SCALE_BITS;
+	}
+	p_env_plan->output_scale = level_scale_table[p_op_params->output_level] + 1;
+}
 
-		// Write mono to stereo output buffer
-		*out++ = master_buffer;
-		*out++ = master_buffer;
+/**
+ * @brief Compute the per-note phase increments of one operator of a plan at the engine sample rate.
+ *
+ * @param data engine
+ * @param p_plan
+ * @param operator_idx 0..NUM_OPERATORS - 1
+ */
+static void plan_update_frequency(synth_data_t *data, render_plan_t *p_plan, uint32_t operator_idx) {
+	const oscillator_params_t *p_osc_params = &p_plan->voice_params.operators[operator_idx].osc;
+	for (uint32_t note = 0; note < NUM_MIDI_NOTES; note++) {
+		uint32_t log_freq = get_oscillator_log_frequency(note, p_osc_params->mode, p_osc_params->frequency_coarse, p_osc_params->frequency_fine, p_osc_params->detune);
+		p_plan->phase_inc[operator_idx][note] = get_phase_from_log_frequency(data->log_freq_to_phase_table, log_freq);
 	}
+}
 
-	return paContinue;
+/**
+ * @brief Build the render plan of a patch at the engine sample rate.
+ *
+ * @param data engine
+ * @param p_params patch, may point into p_plan
+ * @param hash render_plan_hash() of p_params
+ * @param p_plan plan not referenced by the audio thread
+ */
+static void synthesizer_build_plan(synth_data_t *data, const voice_params_t *p_params, uint64_t hash, render_plan_t *p_plan) {
+	if (&p_plan->voice_params != p_params) {
+		p_plan->voice_params = *p_params;
+	}
+	p_plan->hash = hash;
+
+	plan_update_routing(p_plan);
+	for (uint32_t operator_idx = 0; operator_idx < NUM_OPERATORS; operator_idx++) {
+		plan_update_envelope(data, p_plan, operator_idx);
+		plan_update_frequency(data, p_plan, operator_idx);
+	}
+}
+
+/**
+ * @brief Switch the engine to a patch. Its render plan is taken from the cache or built on the calling thread, the
+ * audio thread picks it up at the start of its next buffer, so a buffer never mixes two patches. Must only be called
+ * from one (control) thread.
+ *
+ * @param data engine
+ * @param p_params patch
+ * @return RET_CODE_ERROR if every cached plan is still in use
+ */
+ret_code_t synthesizer_set_patch(synth_data_t *data, const voice_params_t *p_params) {
+	render_plan_cache_t *p_cache = &data->plan_cache;
+	uint64_t hash = render_plan_hash(p_params);
+
+	render_plan_t *p_plan = render_plan_cache_find(p_cache, p_params, hash);
+	if (p_plan == NULL) {
+		p_plan = render_plan_cache_get_slot(p_cache);
+		if (p_plan == NULL) {
+			log_error("No free render plan slot");
+			return RET_CODE_ERROR;
+		}
+		synthesizer_build_plan(data, p_params, hash, p_plan);
+	}
+
+	// Parameter edits queued until now belong to the previous patch
+	atomic_store_explicit(&data->param_edit_barrier, param_queue_get_write_index(&data->param_queue), memory_order_relaxed);
+	render_plan_publish(p_cache, p_plan);
+	data->patch_edited = false;
+	return RET_CODE_OK;
+}
+
+/**
+ * @brief Get the patch last set with synthesizer_set_patch(), including the parameter edits queued since.
+ * Control thread only.
+ *
+ * @param data engine
+ * @return patch, NULL if none was set
+ */
+const voice_params_t *synthesizer_get_patch(synth_data_t *data) {
+	if (data->patch_edited) {
+		return &data->edited_params;
+	}
+
+	render_plan_t *p_plan = data->plan_cache.p_published;
+	return p_plan != NULL ? &p_plan->voice_params : NULL;
+}
+
+/**
+ * @brief Queue an edit of one parameter of the current patch. Edits are applied on the audio thread at the start of
+ * its next buffer, recomputing only the data derived from the edited parameters. Must only be called from the thread
+ * that sets patches.
+ *
+ * @param data engine
+ * @param operator_idx 0..NUM_OPERATORS - 1, ignored for patch-wide parameters
+ * @param param_id param_id_t
+ * @param value
+ * @return RET_CODE_ERROR if there is no patch, the edit is invalid or the queue is full
+ */
+ret_code_t synthesizer_queue_param_edit(synth_data_t *data, uint8_t operator_idx, uint8_t param_id, uint8_t value) {
+	param_edit_t edit = {
+			.operator_idx = operator_idx,
+			.param_id = param_id,
+			.value = value,
+	};
+
+	const voice_params_t *p_params = synthesizer_get_patch(data);
+	if (p_params == NULL || param_edit_validate(&edit) != RET_CODE_OK) {
+		param_queue_count_rejected(&data->param_queue);
+		return RET_CODE_ERROR;
+	}
+
+	RET_ON_FAIL(param_queue_push(&data->param_queue, &edit));
+
+	if (!data->patch_edited) {
+		data->edited_params = *p_params;
+		data->patch_edited = true;
+	}
+	param_edit_apply(&data->edited_params, &edit);
+
+	return RET_CODE_OK;
+}
+
+void synthesizer_get_param_counters(synth_data_t *data, param_queue_counters_t *p_counters) {
+	param_queue_get_counters(&data->param_queue, p_counters);
+}
+
+/**
+ * @brief Apply the queued parameter edits to the audio thread copy of the plan. Edits are coalesced: the derived
+ * data of an operator is recomputed once per buffer, however many of its parameters changed.
+ *
+ * @param data
+ */
+static void synthesizer_apply_param_edits(synth_data_t *data) {
+	uint8_t envelope_mask = 0;
+	uint8_t frequency_mask = 0;
+	bool routing = false;
+
+	param_edit_t edit;
+	while (param_queue_peek(&data->param_queue, &edit)) {
+		// A patch published after the edit was queued is taken with the next buffer, the edit applies to it
+		if (data->p_plan == NULL || render_plan_is_pending(&data->plan_cache)) {
+			break;
+		}
+
+		// Copy on the first edit, the cached plan stays unchanged for the control thread
+		if (data->p_plan != &data->edit_plan) {
+			data->edit_plan = *data->p_plan;
+			if (!render_plan_release(&data->plan_cache, data->p_plan)) {
+				break;
+			}
+			data->p_plan = &data->edit_plan;
+		}
+
+		param_queue_pop(&data->param_queue);
+		uint32_t effect = param_edit_apply(&data->edit_plan.voice_params, &edit);
+		uint8_t operator_bit = edit.param_id < PARAM_ID_NUM_OPERATOR ? 1 << edit.operator_idx : 0;
+		envelope_mask |= effect & PARAM_EFFECT_ENVELOPE ? operator_bit : 0;
+		frequency_mask |= effect & PARAM_EFFECT_FREQUENCY ? operator_bit : 0;
+		routing |= (effect & PARAM_EFFECT_ROUTING) != 0;
+	}
+
+	if (routing) {
+		plan_update_routing(&data->edit_plan);
+	}
+
+	for (uint32_t operator_idx = 0; operator_idx < NUM_OPERATORS; operator_idx++) {
+		if (envelope_mask & (1 << operator_idx)) {
+			plan_update_envelope(data, &data->edit_plan, operator_idx);
+		}
+
+		if (frequency_mask & (1 << operator_idx)) {
+			RENDER_PROFILE_BEGIN(profile_timer);
+			plan_update_frequency(data, &data->edit_plan, operator_idx);
+			for (uint32_t voice_idx = 0; voice_idx < NUM_VOICES; voice_idx++) {
+				uint8_t note = data->voice_data.note[voice_idx] & (NUM_MIDI_NOTES - 1);
+				data->voice_data.phase_inc[operator_idx][voice_idx] = data->edit_plan.phase_inc[operator_idx][note];
+			}
+			RENDER_PROFILE_LAP(profile_timer, RENDER_STAGE_FREQUENCY);
+		}
+	}
+}
+
+/**
+ * @brief Switch to the render plan published since the last buffer, if any, and apply the queued parameter edits.
+ *
+ * @param data
+ */
+static void synthesizer_update_patch(synth_data_t *data) {
+	render_plan_t *p_plan = render_plan_take(&data->plan_cache, data->p_plan);
+	if (p_plan != NULL) {
+		data->p_plan = p_plan;
+		param_queue_discard_before(&data->param_queue, atomic_load_explicit(&data->param_edit_barrier, memory_order_relaxed));
+		for (uint32_t voice_idx = 0; voice_idx < NUM_VOICES; voice_idx++) {
+			synthesizer_update_phase_increments(data, voice_idx);
+		}
+	}
+
+	synthesizer_apply_param_edits(data);
+}
+
+/**
+ * @brief Render frames into a caller provided buffer. All queued MIDI events are applied before the first frame,
+ * callers that need exact event timing queue the events between calls.
+ *
+ * @param data engine
+ * @param p_out interleaved stereo output, 2 * num_frames samples
+ * @param num_frames
+ */
+void synthesizer_render_frames(synth_data_t *data, int32_t *p_out, uint32_t num_frames) {
+	synthesizer_update_patch(data);
+
+	midi_event_t event;
+	while (midi_queue_pop(&data->midi_queue, &event)) {
+		synthesizer_apply_midi_event(data, &event);
+	}
+
+	synthesizer_render_block(data, p_out, num_frames);
+}
+
+/**
+ * @brief Render frames into a caller provided float buffer, full scale is -1.0..1.0.
+ *
+ * @param data engine
+ * @param p_out interleaved stereo output, 2 * num_frames samples
+ * @param num_frames
+ */
+void synthesizer_render_frames_float(synth_data_t *data, float *p_out, uint32_t num_frames) {
+	int32_t buffer[AUDIO_FRAMES_PER_BUFFER * 2];
+
+	while (num_frames > 0) {
+		uint32_t block_frames = num_frames < AUDIO_FRAMES_PER_BUFFER ? num_frames : AUDIO_FRAMES_PER_BUFFER;
+		synthesizer_render_frames(data, buffer, block_frames);
+		for (uint32_t i = 0; i < block_frames * 2; i++) {
+			*p_out++ = (float) buffer[i] * (1.0f / 2147483648.0f);
+		}
+		num_frames -= block_frames;
+	}
+}
+
+/**
+ * @brief Render frames of a real-time stream. MIDI events are applied at the frame matching their timestamp,
+ * delayed by one callback period.
+ *
+ * @param data engine
+ * @param p_out interleaved stereo output, 2 * num_frames samples
+ * @param num_frames
+ */
+void synthesizer_render_realtime(synth_data_t *data, int32_t *p_out, uint32_t num_frames) {
+	uint64_t now_ns = midi_queue_timestamp_now();
+	data->peak_active_voices = 0;
+
+	synthesizer_update_patch(data);
+
+	uint64_t period_start_ns = data->last_callback_ns != 0 ? data->last_callback_ns : now_ns;
+	data->last_callback_ns = now_ns;
+
+	// Split the buffer at the MIDI events queued during the previous callback period
+	uint32_t frame_idx = 0;
+	midi_event_t event;
+	while (midi_queue_peek(&data->midi_queue, &event) && event.timestamp_ns < now_ns) {
+		uint32_t event_frame = midi_event_get_frame(&event, period_start_ns, data->sample_rate, num_frames);
+		if (event_frame > frame_idx) {
+			synthesizer_render_block(data, p_out + frame_idx * 2, event_frame - frame_idx);
+			frame_idx = event_frame;
+		}
+
+		midi_queue_pop(&data->midi_queue, &event);
+		synthesizer_apply_midi_event(data, &event);
+	}
+
+	synthesizer_render_block(data, p_out + frame_idx * 2, num_frames - frame_idx);
+
+	uint64_t period_ns = (uint64_t) num_frames * 1000000000ULL / data->sample_rate;
+	uint32_t load_permille = render_stats_record_callback(&data->render_stats, midi_queue_timestamp_now() - now_ns,
+														  period_ns, num_frames, data->peak_active_voices);
+
+	// Adapt the voice limit for the next callback
+	uint16_t voice_limit = data->voice_allocator.voice_limit;
+	uint16_t new_voice_limit = voice_governor_next_limit(&data->voice_governor, load_permille, data->peak_active_voices, voice_limit);
+	if (new_voice_limit != voice_limit) {
+		uint32_t num_voices_freed = voice_set_limit(data, new_voice_limit);
+		voice_governor_record(&data->voice_governor, now_ns, voice_limit, new_voice_limit, num_voices_freed);
+	}
 }
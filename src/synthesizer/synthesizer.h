@@ -6,9 +6,16 @@
 #define FM_SYNTHESIZER_SYNTHESIZER_H
 
 #include "common.h"
-#include "portaudio.h"
+#include <stdatomic.h>
 #include "patch_file.h"
 #include "config.h"
+#include "midi_queue.h"
+#include "param_queue.h"
+#include "render_stats.h"
+#include "render_profile.h"
+#include "voice_governor.h"
+#include "worker_pool.h"
+#include "visualization.h"
 
 typedef enum {
 	ENVELOPE_STATE_ATTACK,
@@ -21,35 +28,208 @@ typedef enum {
 typedef struct {
 	envelope_state_t state;
 	int32_t level;
+	int32_t ramp_level;
+	int32_t ramp_step;
 } envelope_data_t;
 
-typedef struct {
-	uint32_t phase;
-	int32_t input_mod_buffer;
-	envelope_data_t envelope_data;
-} operator_data_t;
+#define VOICE_MASK_WORDS		((NUM_VOICES + 63) / 64)
 
+/**
+ * Voice state in structure-of-arrays layout: every per-operator field is a contiguous array indexed by voice,
+ * so the operator kernel can process SIMD_LANES voices at once. active_mask has a bit per enabled voice, the
+ * render loops only visit its set bits.
+ */
 typedef struct {
-	uint8_t enable:1;
-	uint8_t gate:1;
-	uint8_t note;
-	int32_t feedback_buffer;
-	operator_data_t operator_data[NUM_OPERATORS];
+	uint32_t phase[NUM_OPERATORS][NUM_VOICES];
+	uint32_t phase_inc[NUM_OPERATORS][NUM_VOICES];
+	int32_t input_mod_buffer[NUM_OPERATORS][NUM_VOICES];
+	uint32_t level[NUM_OPERATORS][NUM_VOICES];
+	envelope_data_t envelope_data[NUM_OPERATORS][NUM_VOICES];
+	int32_t feedback_buffer[NUM_VOICES];
+	uint8_t enable[NUM_VOICES];
+	uint8_t gate[NUM_VOICES];
+	uint8_t note[NUM_VOICES];
+	uint64_t active_mask[VOICE_MASK_WORDS];
 } voice_data_t;
 
+#define VOICE_NONE				0xFFFF
+#define NUM_MIDI_NOTES			128
+
+typedef enum {
+	VOICE_LIST_FREE,
+	VOICE_LIST_RELEASED,
+	VOICE_LIST_ACTIVE,
+	VOICE_LIST_COUNT,
+} voice_list_t;
+
+typedef enum {
+	VOICE_STEAL_POLICY_NONE,
+	VOICE_STEAL_POLICY_OLDEST,
+	VOICE_STEAL_POLICY_QUIETEST,
+	VOICE_STEAL_POLICY_SAME_NOTE,
+} voice_steal_policy_t;
+
+/**
+ * Voice allocation state. Every voice is in exactly one of the free (disabled), released (enabled, gate off)
+ * and active (gated) lists, each ordered from oldest to newest. Enabled voices are also chained per note.
+ */
+typedef struct {
+	uint16_t list_prev[NUM_VOICES];
+	uint16_t list_next[NUM_VOICES];
+	uint8_t list[NUM_VOICES];
+	uint16_t list_head[VOICE_LIST_COUNT];
+	uint16_t list_tail[VOICE_LIST_COUNT];
+	uint16_t list_count[VOICE_LIST_COUNT];
+	uint16_t note_prev[NUM_VOICES];
+	uint16_t note_next[NUM_VOICES];
+	uint16_t note_head[NUM_MIDI_NOTES];
+	voice_steal_policy_t steal_policy;
+	// At most this many voices are enabled, lowered by the polyphony governor under load
+	uint16_t voice_limit;
+	uint32_t num_stolen;
+} voice_allocator_t;
+
+/**
+ * Renders one frame of the voices voice_start..voice_end - 1 for one algorithm, returns the sum of the carrier samples.
+ */
+typedef int32_t (*algorithm_kernel_t)(voice_data_t *p_voice_data, uint8_t feedback_shift, uint32_t voice_start, uint32_t voice_end);
+
+/**
+ * Envelope of one operator with the level steps of every segment scaled to the engine sample rate.
+ */
+typedef struct {
+	int32_t target_level[ENVELOPE_STATE_OFF];
+	int64_t rise_step[ENVELOPE_STATE_OFF];
+	int64_t fall_step[ENVELOPE_STATE_OFF];
+	int32_t output_scale;
+} envelope_plan_t;
+
+/**
+ * Render plan of a patch: the decoded parameters and everything the render loop derives from them at the engine
+ * sample rate. A plan is built off the audio thread and does not change while the audio thread can reach it.
+ */
 typedef struct {
-	voice_data_t voice_data[NUM_VOICES];
 	voice_params_t voice_params;
+	uint64_t hash;
+	algorithm_kernel_t algorithm_kernel;
+	uint8_t carrier_mask;
+	uint8_t feedback_shift;
+	envelope_plan_t envelope[NUM_OPERATORS];
+	uint32_t phase_inc[NUM_OPERATORS][NUM_MIDI_NOTES];
+} render_plan_t;
+
+#define RENDER_PLAN_NUM_RETIRED		4
+#define RENDER_PLAN_RETIRED_MASK	(RENDER_PLAN_NUM_RETIRED - 1)
+
+/**
+ * Plans of the recently used patches, keyed by parameter hash. The control thread builds plans and publishes them
+ * through p_pending, the audio thread takes the pending plan between buffers and hands the plan it replaces back
+ * through the retired ring. A slot is only rebuilt once neither thread references it.
+ */
+typedef struct {
+	render_plan_t plans[RENDER_PLAN_CACHE_SIZE];
+	bool valid[RENDER_PLAN_CACHE_SIZE];
+	uint32_t num_refs[RENDER_PLAN_CACHE_SIZE];
+	uint32_t last_used[RENDER_PLAN_CACHE_SIZE];
+	uint32_t use_counter;
+	render_plan_t *p_published;
+	render_plan_t *_Atomic p_pending;
+	render_plan_t *p_retired[RENDER_PLAN_NUM_RETIRED];
+	atomic_uint retired_write_index;
+	atomic_uint retired_read_index;
+} render_plan_cache_t;
+
+/**
+ * Culling statistics of an engine, counted since it was initialized.
+ */
+typedef struct {
+	uint64_t num_operator_samples;
+	uint64_t num_operator_samples_culled;
+	uint32_t num_voices_retired_early;
+} synthesizer_cull_counters_t;
+
+/**
+ * Engine instance. All render state lives here, engines only share the read-only lookup tables,
+ * so one process can run any number of them (e.g. one per core).
+ */
+typedef struct {
+	voice_data_t voice_data;
+	voice_allocator_t voice_allocator;
+	render_plan_cache_t plan_cache;
+	render_plan_t *p_plan;
+	// Audio thread copy of the current plan that queued parameter edits are applied to
+	render_plan_t edit_plan;
+	param_queue_t param_queue;
+	// Edits queued before this param_queue index belong to a replaced patch
+	atomic_uint param_edit_barrier;
+	// Control thread view of the edited patch, valid while patch_edited is set
+	voice_params_t edited_params;
+	bool patch_edited;
+	patch_file_t patch_file;
+	uint32_t sample_rate;
+	uint32_t envelope_rate_scale;
+	uint32_t log_freq_to_phase_table[LOG_FREQ_TO_PHASE_TABLE_SIZE + 1];
+	uint16_t retire_level;
+	midi_queue_t midi_queue;
+	uint64_t last_callback_ns;
+	uint32_t envelope_block_frame;
+	visualization_t *p_visualization;
+	uint32_t chunk_num_frames;
+	int32_t chunk_mix[NUM_RENDER_CHUNKS][RENDER_BLOCK_FRAMES] __attribute__((aligned(64)));
+	uint32_t chunk_num_culled[NUM_RENDER_CHUNKS];
+	atomic_uint_fast64_t num_operator_samples;
+	atomic_uint_fast64_t num_operator_samples_culled;
+	atomic_uint num_voices_retired_early;
+	uint32_t peak_active_voices;
+	render_stats_t render_stats;
+	render_profile_t render_profile;
+	voice_governor_t voice_governor;
+	worker_pool_t *p_worker_pool;
+	uint32_t parallel_min_voices;
 } synth_data_t;
 
-extern synth_data_t synth_data;
+ret_code_t synthesizer_init(synth_data_t *data, uint32_t sample_rate);
+
+ret_code_t synthesizer_init_engine(synth_data_t *data, uint32_t sample_rate);
+
+ret_code_t synthesizer_set_sample_rate(synth_data_t *data, uint32_t sample_rate);
+
+ret_code_t synthesizer_start_workers(synth_data_t *data, uint32_t num_threads, uint32_t min_parallel_voices);
+
+void synthesizer_stop_workers(synth_data_t *data);
+
+void synthesizer_update_phase_increments(synth_data_t *data, uint32_t voice_idx);
+
+ret_code_t synthesizer_set_patch(synth_data_t *data, const voice_params_t *p_params);
+
+const voice_params_t *synthesizer_get_patch(synth_data_t *data);
+
+ret_code_t synthesizer_queue_param_edit(synth_data_t *data, uint8_t operator_idx, uint8_t param_id, uint8_t value);
+
+void synthesizer_get_param_counters(synth_data_t *data, param_queue_counters_t *p_counters);
+
+void synthesizer_set_retire_level(synth_data_t *data, uint16_t retire_level);
+
+void synthesizer_get_cull_counters(synth_data_t *data, synthesizer_cull_counters_t *p_counters);
+
+ret_code_t synthesizer_queue_midi_event(synth_data_t *data, uint8_t status, uint8_t data1, uint8_t data2);
+
+void synthesizer_get_midi_counters(synth_data_t *data, midi_queue_counters_t *p_counters);
+
+void synthesizer_get_render_stats(synth_data_t *data, render_stats_snapshot_t *p_snapshot);
+
+void synthesizer_get_render_profile(synth_data_t *data, render_profile_snapshot_t *p_snapshot);
+
+void synthesizer_set_governor_enabled(synth_data_t *data, bool enabled);
+
+void synthesizer_get_governor_counters(synth_data_t *data, voice_governor_counters_t *p_counters);
+
+uint32_t synthesizer_log_governor_events(synth_data_t *data);
+
+void synthesizer_render_frames(synth_data_t *data, int32_t *p_out, uint32_t num_frames);
 
-ret_code_t synthesizer_init(void);
+void synthesizer_render_frames_float(synth_data_t *data, float *p_out, uint32_t num_frames);
 
-int synthesizer_render(const void *input_buffer, void *output_buffer,
-					   unsigned long frames_per_buffer,
-					   const PaStreamCallbackTimeInfo *time_info,
-					   PaStreamCallbackFlags status_flags,
-					   void *user_data);
+void synthesizer_render_realtime(synth_data_t *data, int32_t *p_out, uint32_t num_frames);
 
 #endif //FM_SYNTHESIZER_SYNTHESIZER_H
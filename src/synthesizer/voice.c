@@ -6,87 +6,320 @@
 #include <stdbool.h>
 #include "synthesizer.h"
 
-bool voice_active[NUM_VOICES];
+// A voice is allocated while it is enabled, until all of its envelopes are off. The allocator keeps every voice in
+// one of three lists and chains enabled voices per note, so note-on and note-off never scan all voices.
 
-void voice_init(void) {
-	for (uint8_t i = 0; i < NUM_VOICES; i++) {
-		voice_active[i] = false;
-		synth_data.voice_data[i].enable = 0;
-		synth_data.voice_data[i].gate = 0;
-		synth_data.voice_data[i].note = 0;
+static void voice_list_remove(voice_allocator_t *p_alloc, uint16_t voice_idx) {
+	uint8_t list = p_alloc->list[voice_idx];
+	uint16_t prev = p_alloc->list_prev[voice_idx];
+	uint16_t next = p_alloc->list_next[voice_idx];
+
+	if (prev != VOICE_NONE) {
+		p_alloc->list_next[prev] = next;
+	} else {
+		p_alloc->list_head[list] = next;
+	}
+
+	if (next != VOICE_NONE) {
+		p_alloc->list_prev[next] = prev;
+	} else {
+		p_alloc->list_tail[list] = prev;
 	}
+	p_alloc->list_count[list]--;
 }
 
-void voice_update(void) {
-	for (uint8_t i = 0; i < NUM_VOICES; i++) {
-		if (voice_active[i]) {
-			bool voice_off = true;
-			for (uint8_t j = 0; j < NUM_OPERATORS; j++) {
-				if (synth_data.voice_data[i].operator_data[j].envelope_data.state != ENVELOPE_STATE_OFF) {
-					voice_off = false;
-					break;
-				}
-			}
+static void voice_list_append(voice_allocator_t *p_alloc, uint8_t list, uint16_t voice_idx) {
+	uint16_t tail = p_alloc->list_tail[list];
+
+	p_alloc->list[voice_idx] = list;
+	p_alloc->list_prev[voice_idx] = tail;
+	p_alloc->list_next[voice_idx] = VOICE_NONE;
+	if (tail != VOICE_NONE) {
+		p_alloc->list_next[tail] = voice_idx;
+	} else {
+		p_alloc->list_head[list] = voice_idx;
+	}
+	p_alloc->list_tail[list] = voice_idx;
+	p_alloc->list_count[list]++;
+}
+
+static void voice_list_move(voice_allocator_t *p_alloc, uint8_t list, uint16_t voice_idx) {
+	voice_list_remove(p_alloc, voice_idx);
+	voice_list_append(p_alloc, list, voice_idx);
+}
+
+static void voice_note_remove(voice_allocator_t *p_alloc, uint8_t midi_key, uint16_t voice_idx) {
+	uint16_t prev = p_alloc->note_prev[voice_idx];
+	uint16_t next = p_alloc->note_next[voice_idx];
+
+	if (prev != VOICE_NONE) {
+		p_alloc->note_next[prev] = next;
+	} else {
+		p_alloc->note_head[midi_key] = next;
+	}
+
+	if (next != VOICE_NONE) {
+		p_alloc->note_prev[next] = prev;
+	}
+}
+
+static void voice_note_insert(voice_allocator_t *p_alloc, uint8_t midi_key, uint16_t voice_idx) {
+	uint16_t head = p_alloc->note_head[midi_key];
+
+	p_alloc->note_prev[voice_idx] = VOICE_NONE;
+	p_alloc->note_next[voice_idx] = head;
+	if (head != VOICE_NONE) {
+		p_alloc->note_prev[head] = voice_idx;
+	}
+	p_alloc->note_head[midi_key] = voice_idx;
+}
+
+/**
+ * @brief Reset the allocator, all voices become free in index order. The steal policy and voice limit are kept.
+ *
+ * @param data engine
+ */
+void voice_init(synth_data_t *data) {
+	voice_allocator_t *p_alloc = &data->voice_allocator;
+
+	for (uint8_t i = 0; i < VOICE_LIST_COUNT; i++) {
+		p_alloc->list_head[i] = VOICE_NONE;
+		p_alloc->list_tail[i] = VOICE_NONE;
+		p_alloc->list_count[i] = 0;
+	}
+	for (uint32_t i = 0; i < NUM_MIDI_NOTES; i++) {
+		p_alloc->note_head[i] = VOICE_NONE;
+	}
+	p_alloc->num_stolen = 0;
+
+	for (uint32_t i = 0; i < VOICE_MASK_WORDS; i++) {
+		data->voice_data.active_mask[i] = 0;
+	}
+	for (uint32_t i = 0; i < NUM_VOICES; i++) {
+		data->voice_data.enable[i] = 0;
+		data->voice_data.gate[i] = 0;
+		data->voice_data.note[i] = 0;
+		voice_list_append(p_alloc, VOICE_LIST_FREE, i);
+	}
+}
+
+static void voice_free(synth_data_t *data, uint16_t voice_idx) {
+	voice_allocator_t *p_alloc = &data->voice_allocator;
+
+	voice_note_remove(p_alloc, data->voice_data.note[voice_idx], voice_idx);
+	voice_list_move(p_alloc, VOICE_LIST_FREE, voice_idx);
+	data->voice_data.active_mask[voice_idx >> 6] &= ~(1ULL << (voice_idx & 63));
+	data->voice_data.enable[voice_idx] = 0;
+	data->voice_data.gate[voice_idx] = 0;
+	data->voice_data.note[voice_idx] = 0;
+}
+
+/**
+ * @brief Check whether every carrier of a voice is at least as attenuated as the retire level.
+ */
+static bool voice_is_below_retire_level(synth_data_t *data, uint16_t voice_idx) {
+	uint8_t carrier_mask = data->p_plan->carrier_mask;
+	if (data->retire_level == 0 || carrier_mask == 0) {
+		return false;
+	}
+
+	for (uint8_t j = 0; j < NUM_OPERATORS; j++) {
+		if ((carrier_mask & (1 << j)) && data->voice_data.level[j][voice_idx] < data->retire_level) {
+			return false;
+		}
+	}
+
+	return true;
+}
 
-			if (voice_off) {
-				voice_active[i] = false;
-				synth_data.voice_data[i].enable = 0;
-				synth_data.voice_data[i].gate = 0;
-				synth_data.voice_data[i].note = 0;
+/**
+ * @brief Free released voices whose envelopes have all reached the off state, or whose carriers all fell below
+ * the retire level. Gated voices are never freed. Called on the audio thread at the end of every render block.
+ *
+ * @param data engine
+ */
+void voice_update(synth_data_t *data) {
+	voice_allocator_t *p_alloc = &data->voice_allocator;
+	uint16_t voice_idx = p_alloc->list_head[VOICE_LIST_RELEASED];
+
+	while (voice_idx != VOICE_NONE) {
+		uint16_t next = p_alloc->list_next[voice_idx];
+
+		bool voice_off = true;
+		for (uint8_t j = 0; j < NUM_OPERATORS; j++) {
+			if (data->voice_data.envelope_data[j][voice_idx].state != ENVELOPE_STATE_OFF) {
+				voice_off = false;
+				break;
 			}
 		}
+
+		if (!voice_off && voice_is_below_retire_level(data, voice_idx)) {
+			atomic_fetch_add_explicit(&data->num_voices_retired_early, 1, memory_order_relaxed);
+			voice_off = true;
+		}
+
+		if (voice_off) {
+			voice_free(data, voice_idx);
+		}
+
+		voice_idx = next;
 	}
 }
 
-ret_code_t voice_assign_key(uint8_t midi_key, uint8_t velocity) {
-	bool found = false;
-
-	// Find inactive voice
-	for (uint8_t i = 0; i < NUM_VOICES; i++) {
-		if (!voice_active[i]) {
-			voice_active[i] = true;
-			synth_data.voice_data[i].enable = 1;
-			synth_data.voice_data[i].gate = 1;
-			synth_data.voice_data[i].note = midi_key;
-			for (uint8_t j = 0; j < NUM_OPERATORS; j++) {
-				synth_data.voice_data[i].operator_data[j].envelope_data.state = ENVELOPE_STATE_ATTACK;
-				synth_data.voice_data[i].operator_data[j].envelope_data.level = 0;
+/**
+ * @brief Select what a note-on does when every voice is gated.
+ *
+ * @param data engine
+ * @param steal_policy policy, VOICE_STEAL_POLICY_NONE drops the note
+ */
+void voice_set_steal_policy(synth_data_t *data, voice_steal_policy_t steal_policy) {
+	data->voice_allocator.steal_policy = steal_policy;
+}
+
+static void voice_start(synth_data_t *data, uint16_t voice_idx, uint8_t midi_key) {
+	voice_allocator_t *p_alloc = &data->voice_allocator;
+
+	if (data->voice_data.enable[voice_idx]) {
+		voice_note_remove(p_alloc, data->voice_data.note[voice_idx], voice_idx);
+	}
+	voice_note_insert(p_alloc, midi_key, voice_idx);
+	voice_list_move(p_alloc, VOICE_LIST_ACTIVE, voice_idx);
+
+	data->voice_data.active_mask[voice_idx >> 6] |= 1ULL << (voice_idx & 63);
+	data->voice_data.enable[voice_idx] = 1;
+	data->voice_data.gate[voice_idx] = 1;
+	data->voice_data.note[voice_idx] = midi_key;
+	synthesizer_update_phase_increments(data, voice_idx);
+	for (uint8_t j = 0; j < NUM_OPERATORS; j++) {
+		// Loudest until the next render, so a quietest steal in the same batch does not take the new note
+		data->voice_data.level[j][voice_idx] = 0;
+		data->voice_data.envelope_data[j][voice_idx].state = ENVELOPE_STATE_ATTACK;
+		data->voice_data.envelope_data[j][voice_idx].level = 0;
+		data->voice_data.envelope_data[j][voice_idx].ramp_level = 0;
+		data->voice_data.envelope_data[j][voice_idx].ramp_step = 0;
+	}
+}
+
+/**
+ * @brief Find the voice of a list with the highest attenuation on its loudest carrier, modulators are not audible
+ * on their own. Only used for stealing and shedding, so the scan is off the common path.
+ */
+static uint16_t voice_find_quietest(synth_data_t *data, voice_list_t list) {
+	voice_allocator_t *p_alloc = &data->voice_allocator;
+	uint8_t carrier_mask = data->p_plan != NULL ? data->p_plan->carrier_mask : 0;
+	uint16_t quietest_idx = VOICE_NONE;
+	uint32_t quietest_level = 0;
+
+	for (uint16_t voice_idx = p_alloc->list_head[list]; voice_idx != VOICE_NONE;
+		 voice_idx = p_alloc->list_next[voice_idx]) {
+		uint32_t min_level = UINT32_MAX;
+		for (uint8_t j = 0; j < NUM_OPERATORS; j++) {
+			if ((carrier_mask & (1 << j)) && data->voice_data.level[j][voice_idx] < min_level) {
+				min_level = data->voice_data.level[j][voice_idx];
 			}
-			found = true;
-			break;
+		}
+
+		// Strictly greater keeps the oldest voice on ties
+		if (quietest_idx == VOICE_NONE || min_level > quietest_level) {
+			quietest_idx = voice_idx;
+			quietest_level = min_level;
 		}
 	}
 
-	// Find voice in release state
-	if (!found) {
-		for (uint8_t i = 0; i < NUM_VOICES; i++) {
-			if (voice_active[i] && synth_data.voice_data[i].gate == 0) {
-				voice_active[i] = true;
-				synth_data.voice_data[i].enable = 1;
-				synth_data.voice_data[i].gate = 1;
-				synth_data.voice_data[i].note = midi_key;
-				for (uint8_t j = 0; j < NUM_OPERATORS; j++) {
-					synth_data.voice_data[i].operator_data[j].envelope_data.state = ENVELOPE_STATE_ATTACK;
-					synth_data.voice_data[i].operator_data[j].envelope_data.level = 0;
-				}
-				found = true;
+	return quietest_idx;
+}
+
+/**
+ * @brief Start a voice for a key. Uses the longest free voice, else the oldest released voice, else steals a gated
+ * voice according to the steal policy. With VOICE_STEAL_POLICY_SAME_NOTE a voice already sounding the key is
+ * retriggered before anything else. At the voice limit, free voices are not used and the quietest released voice
+ * is taken instead.
+ *
+ * @param data engine
+ * @param midi_key key
+ * @param velocity velocity, unused
+ * @return RET_CODE_OK on success, RET_CODE_ERROR if the note was dropped
+ */
+ret_code_t voice_assign_key(synth_data_t *data, uint8_t midi_key, uint8_t velocity) {
+	voice_allocator_t *p_alloc = &data->voice_allocator;
+	uint16_t voice_idx = VOICE_NONE;
+
+	if (p_alloc->steal_policy == VOICE_STEAL_POLICY_SAME_NOTE) {
+		voice_idx = p_alloc->note_head[midi_key];
+	}
+
+	bool at_limit = p_alloc->list_count[VOICE_LIST_RELEASED] + p_alloc->list_count[VOICE_LIST_ACTIVE] >= p_alloc->voice_limit;
+
+	if (voice_idx == VOICE_NONE && !at_limit) {
+		voice_idx = p_alloc->list_head[VOICE_LIST_FREE];
+	}
+
+	if (voice_idx == VOICE_NONE) {
+		// Only the governor limits below full polyphony, it gives up the least audible release tail
+		voice_idx = p_alloc->voice_limit < NUM_VOICES ? voice_find_quietest(data, VOICE_LIST_RELEASED)
+													  : p_alloc->list_head[VOICE_LIST_RELEASED];
+	}
+
+	if (voice_idx == VOICE_NONE) {
+		switch (p_alloc->steal_policy) {
+			case VOICE_STEAL_POLICY_OLDEST:
+			case VOICE_STEAL_POLICY_SAME_NOTE:
+				voice_idx = p_alloc->list_head[VOICE_LIST_ACTIVE];
 				break;
-			}
+			case VOICE_STEAL_POLICY_QUIETEST:
+				voice_idx = voice_find_quietest(data, VOICE_LIST_ACTIVE);
+				break;
+			default:
+				return RET_CODE_ERROR;
 		}
+		p_alloc->num_stolen++;
 	}
 
-	if (!found) {
-		log_error("No free voice found.")
+	if (voice_idx == VOICE_NONE) {
 		return RET_CODE_ERROR;
 	}
 
+	voice_start(data, voice_idx, midi_key);
 	return RET_CODE_OK;
 }
 
-void voice_release_key(uint8_t midi_key, uint8_t velocity) {
-	for (uint8_t i = 0; i < NUM_VOICES; i++) {
-		if (voice_active[i] && synth_data.voice_data[i].note == midi_key) {
-			synth_data.voice_data[i].gate = 0;
+/**
+ * @brief Release the gated voices playing a key. Voices already in release stay where they are.
+ *
+ * @param data engine
+ * @param midi_key key
+ * @param velocity velocity, unused
+ */
+void voice_release_key(synth_data_t *data, uint8_t midi_key, uint8_t velocity) {
+	voice_allocator_t *p_alloc = &data->voice_allocator;
+
+	for (uint16_t voice_idx = p_alloc->note_head[midi_key]; voice_idx != VOICE_NONE;
+		 voice_idx = p_alloc->note_next[voice_idx]) {
+		if (data->voice_data.gate[voice_idx]) {
+			data->voice_data.gate[voice_idx] = 0;
+			voice_list_move(p_alloc, VOICE_LIST_RELEASED, voice_idx);
 		}
 	}
 }
+
+/**
+ * @brief Change the voice limit. Enabled voices above a lower limit are freed right away, the quietest released
+ * voices first, then the quietest gated voices.
+ *
+ * @param data engine
+ * @param voice_limit 1..NUM_VOICES
+ * @return number of voices freed
+ */
+uint32_t voice_set_limit(synth_data_t *data, uint16_t voice_limit) {
+	voice_allocator_t *p_alloc = &data->voice_allocator;
+	uint32_t num_freed = 0;
+
+	p_alloc->voice_limit = voice_limit;
+	while (p_alloc->list_count[VOICE_LIST_RELEASED] + p_alloc->list_count[VOICE_LIST_ACTIVE] > voice_limit) {
+		voice_list_t list = p_alloc->list_count[VOICE_LIST_RELEASED] > 0 ? VOICE_LIST_RELEASED : VOICE_LIST_ACTIVE;
+		voice_free(data, voice_find_quietest(data, list));
+		num_freed++;
+	}
+
+	return num_freed;
+}
@@ -7,13 +7,18 @@
 
 #include "common.h"
 #include <stdint.h>
+#include "synthesizer.h"
 
-void voice_init(void);
+void voice_init(synth_data_t *data);
 
-void voice_update(void);
+void voice_update(synth_data_t *data);
 
-ret_code_t voice_assign_key(uint8_t midi_key, uint8_t velocity);
+void voice_set_steal_policy(synth_data_t *data, voice_steal_policy_t steal_policy);
 
-void voice_release_key(uint8_t midi_key, uint8_t velocity);
+ret_code_t voice_assign_key(synth_data_t *data, uint8_t midi_key, uint8_t velocity);
+
+void voice_release_key(synth_data_t *data, uint8_t midi_key, uint8_t velocity);
+
+uint32_t voice_set_limit(synth_data_t *data, uint16_t voice_limit);
 
 #endif //FM_SYNTHESIZER_VOICE_H
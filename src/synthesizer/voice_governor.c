@@ -0,0 +1,135 @@
+//
+// Created by Tim Holzhey on 17.10.26
+//
+
+#include "voice_governor.h"
+
+/**
+ * @brief Reset the governor to full polyphony.
+ *
+ * @param p_governor
+ * @param enabled false keeps the limit at NUM_VOICES
+ */
+void voice_governor_init(voice_governor_t *p_governor, bool enabled) {
+	atomic_init(&p_governor->enabled, enabled);
+	p_governor->smoothed_load = 0;
+	p_governor->hold_callbacks = 0;
+	atomic_init(&p_governor->event_write_index, 0);
+	atomic_init(&p_governor->event_read_index, 0);
+	atomic_init(&p_governor->voice_limit, NUM_VOICES);
+	atomic_init(&p_governor->smoothed_load_permille, 0);
+	atomic_init(&p_governor->num_reductions, 0);
+	atomic_init(&p_governor->num_restores, 0);
+	atomic_init(&p_governor->num_voices_freed, 0);
+	atomic_init(&p_governor->num_events_dropped, 0);
+}
+
+/**
+ * @brief Feed the load of a callback and get the voice limit for the next one. Above the high watermark the limit
+ * drops to 3/4 of the enabled voices, below the low watermark it rises by VOICE_GOVERNOR_RESTORE_STEP. After a
+ * change the limit is held for VOICE_GOVERNOR_HOLD_CALLBACKS, so the smoothed load can follow. Audio thread only.
+ *
+ * @param p_governor
+ * @param load_permille render time of the callback per buffer period, 1000 = deadline
+ * @param num_enabled voices enabled during the callback
+ * @param voice_limit current limit
+ * @return new limit, 1..NUM_VOICES
+ */
+uint16_t voice_governor_next_limit(voice_governor_t *p_governor, uint32_t load_permille, uint32_t num_enabled,
+								   uint16_t voice_limit) {
+	int32_t delta = (int32_t) (load_permille << VOICE_GOVERNOR_LOAD_FRACTION_BITS) - (int32_t) p_governor->smoothed_load;
+	p_governor->smoothed_load += delta / (1 << VOICE_GOVERNOR_SMOOTHING_SHIFT);
+	uint32_t smoothed_load_permille = p_governor->smoothed_load >> VOICE_GOVERNOR_LOAD_FRACTION_BITS;
+	atomic_store_explicit(&p_governor->smoothed_load_permille, smoothed_load_permille, memory_order_relaxed);
+
+	if (!atomic_load_explicit(&p_governor->enabled, memory_order_relaxed)) {
+		return NUM_VOICES;
+	}
+
+	if (p_governor->hold_callbacks > 0) {
+		p_governor->hold_callbacks--;
+		return voice_limit;
+	}
+
+	uint32_t new_limit = voice_limit;
+	if (smoothed_load_permille > VOICE_GOVERNOR_HIGH_LOAD_PERMILLE) {
+		new_limit = (num_enabled < voice_limit ? num_enabled : voice_limit) * 3 / 4;
+		new_limit = new_limit > VOICE_GOVERNOR_MIN_VOICES ? new_limit : VOICE_GOVERNOR_MIN_VOICES;
+		new_limit = new_limit < voice_limit ? new_limit : voice_limit;
+	} else if (smoothed_load_permille < VOICE_GOVERNOR_LOW_LOAD_PERMILLE) {
+		new_limit = voice_limit + VOICE_GOVERNOR_RESTORE_STEP;
+		new_limit = new_limit < NUM_VOICES ? new_limit : NUM_VOICES;
+	}
+
+	if (new_limit != voice_limit) {
+		p_governor->hold_callbacks = VOICE_GOVERNOR_HOLD_CALLBACKS;
+	}
+
+	return (uint16_t) new_limit;
+}
+
+/**
+ * @brief Count a limit change and queue it for logging. Audio thread only, the event is dropped if the reader fell
+ * behind.
+ *
+ * @param p_governor
+ * @param timestamp_ns
+ * @param old_limit
+ * @param new_limit
+ * @param num_voices_freed voices freed to meet a lower limit
+ */
+void voice_governor_record(voice_governor_t *p_governor, uint64_t timestamp_ns, uint16_t old_limit, uint16_t new_limit,
+						   uint32_t num_voices_freed) {
+	atomic_store_explicit(&p_governor->voice_limit, new_limit, memory_order_relaxed);
+	atomic_fetch_add_explicit(new_limit < old_limit ? &p_governor->num_reductions : &p_governor->num_restores, 1,
+							  memory_order_relaxed);
+	atomic_fetch_add_explicit(&p_governor->num_voices_freed, num_voices_freed, memory_order_relaxed);
+
+	uint32_t write_index = atomic_load_explicit(&p_governor->event_write_index, memory_order_relaxed);
+	uint32_t read_index = atomic_load_explicit(&p_governor->event_read_index, memory_order_acquire);
+	if (write_index - read_index >= VOICE_GOVERNOR_NUM_EVENTS) {
+		atomic_fetch_add_explicit(&p_governor->num_events_dropped, 1, memory_order_relaxed);
+		return;
+	}
+
+	uint32_t load_permille = atomic_load_explicit(&p_governor->smoothed_load_permille, memory_order_relaxed);
+	p_governor->events[write_index & VOICE_GOVERNOR_EVENTS_MASK] = (voice_governor_event_t) {
+			.timestamp_ns = timestamp_ns,
+			.old_limit = old_limit,
+			.new_limit = new_limit,
+			.load_permille = (uint16_t) (load_permille < UINT16_MAX ? load_permille : UINT16_MAX),
+			.num_voices_freed = (uint16_t) num_voices_freed,
+	};
+	atomic_store_explicit(&p_governor->event_write_index, write_index + 1, memory_order_release);
+}
+
+/**
+ * @brief Dequeue the oldest limit change. Must only be called from one reader thread.
+ *
+ * @param p_governor
+ * @param p_event
+ * @return false if there is no event
+ */
+bool voice_governor_read_event(voice_governor_t *p_governor, voice_governor_event_t *p_event) {
+	uint32_t read_index = atomic_load_explicit(&p_governor->event_read_index, memory_order_relaxed);
+	uint32_t write_index = atomic_load_explicit(&p_governor->event_write_index, memory_order_acquire);
+
+	if (read_index == write_index) {
+		return false;
+	}
+
+	*p_event = p_governor->events[read_index & VOICE_GOVERNOR_EVENTS_MASK];
+	atomic_store_explicit(&p_governor->event_read_index, read_index + 1, memory_order_release);
+
+	return true;
+}
+
+void voice_governor_get_counters(voice_governor_t *p_governor, voice_governor_counters_t *p_counters) {
+	p_counters->enabled = atomic_load_explicit(&p_governor->enabled, memory_order_relaxed);
+	p_counters->voice_limit = atomic_load_explicit(&p_governor->voice_limit, memory_order_relaxed);
+	p_counters->smoothed_load = atomic_load_explicit(&p_governor->smoothed_load_permille, memory_order_relaxed) / 1000.0;
+	p_counters->num_reductions = atomic_load_explicit(&p_governor->num_reductions, memory_order_relaxed);
+	p_counters->num_restores = atomic_load_explicit(&p_governor->num_restores, memory_order_relaxed);
+	p_counters->num_voices_freed = atomic_load_explicit(&p_governor->num_voices_freed, memory_order_relaxed);
+	p_counters->num_events_dropped = atomic_load_explicit(&p_governor->num_events_dropped, memory_order_relaxed);
+}
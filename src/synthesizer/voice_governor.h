@@ -0,0 +1,73 @@
+//
+// Created by Tim Holzhey on 17.10.26
+//
+
+#ifndef FM_SYNTHESIZER_VOICE_GOVERNOR_H
+#define FM_SYNTHESIZER_VOICE_GOVERNOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "config.h"
+
+#define VOICE_GOVERNOR_NUM_EVENTS			64
+#define VOICE_GOVERNOR_EVENTS_MASK			(VOICE_GOVERNOR_NUM_EVENTS - 1)
+
+// Smoothed load is an exponential moving average with weight 1 / (1 << VOICE_GOVERNOR_SMOOTHING_SHIFT), kept with
+// VOICE_GOVERNOR_LOAD_FRACTION_BITS below the permille so small loads do not round away
+#define VOICE_GOVERNOR_SMOOTHING_SHIFT		3
+#define VOICE_GOVERNOR_LOAD_FRACTION_BITS	8
+
+/**
+ * A change of the voice limit, logged off the audio thread.
+ */
+typedef struct {
+	uint64_t timestamp_ns;
+	uint16_t old_limit;
+	uint16_t new_limit;
+	uint16_t load_permille;
+	uint16_t num_voices_freed;
+} voice_governor_event_t;
+
+/**
+ * Adaptive polyphony limit. Updated by the audio thread after every real-time callback, the changes are passed to
+ * one reader thread through a wait-free ring.
+ */
+typedef struct {
+	atomic_bool enabled;
+	uint32_t smoothed_load;				// permille << VOICE_GOVERNOR_LOAD_FRACTION_BITS, audio thread only
+	uint32_t hold_callbacks;
+	voice_governor_event_t events[VOICE_GOVERNOR_NUM_EVENTS];
+	atomic_uint event_write_index;
+	atomic_uint event_read_index;
+	atomic_uint voice_limit;
+	atomic_uint smoothed_load_permille;
+	atomic_uint num_reductions;
+	atomic_uint num_restores;
+	atomic_uint num_voices_freed;
+	atomic_uint num_events_dropped;
+} voice_governor_t;
+
+typedef struct {
+	bool enabled;
+	uint32_t voice_limit;
+	double smoothed_load;
+	uint32_t num_reductions;
+	uint32_t num_restores;
+	uint32_t num_voices_freed;
+	uint32_t num_events_dropped;
+} voice_governor_counters_t;
+
+void voice_governor_init(voice_governor_t *p_governor, bool enabled);
+
+uint16_t voice_governor_next_limit(voice_governor_t *p_governor, uint32_t load_permille, uint32_t num_enabled,
+								   uint16_t voice_limit);
+
+void voice_governor_record(voice_governor_t *p_governor, uint64_t timestamp_ns, uint16_t old_limit, uint16_t new_limit,
+						   uint32_t num_voices_freed);
+
+bool voice_governor_read_event(voice_governor_t *p_governor, voice_governor_event_t *p_event);
+
+void voice_governor_get_counters(voice_governor_t *p_governor, voice_governor_counters_t *p_counters);
+
+#endif //FM_SYNTHESIZER_VOICE_GOVERNOR_H
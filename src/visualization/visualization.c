@@ -3,45 +3,106 @@
 //
 
 #include <math.h>
+#include <string.h>
 #include "visualization.h"
 #include "config.h"
 #include "stdbool.h"
 
-#define VIZ_SAMPLES_PER_SECOND             60
-#define VIZ_SAMPLE_COUNT                   (AUDIO_SAMPLE_RATE / VIZ_SAMPLES_PER_SECOND)
+/**
+ * @brief Reset the visualization and precompute the window length of every alignment note, so the audio thread
+ * does no floating point work per sample.
+ *
+ * @param p_viz visualization
+ * @param sample_rate Hz, at most AUDIO_MAX_SAMPLE_RATE
+ */
+void visualization_init(visualization_t *p_viz, uint32_t sample_rate) {
+	uint32_t max_window_size = sample_rate / VIZ_SAMPLES_PER_SECOND;
 
-static struct {
-	int32_t samples[VIZ_SAMPLE_COUNT];
-	uint32_t sample_index;
-
-	int32_t transfer_buffer[VIZ_SAMPLE_COUNT];
-	uint32_t transfer_buffer_size;
-	bool transfer_pending;
-} m_viz;
-
-void visualization_add_sample(int32_t sample, uint32_t align_note) {
-	m_viz.samples[m_viz.sample_index++] = sample;
-	double align_freq = BASE_PITCH_FREQUENCY_HZ * pow(2, ((double) align_note - BASE_PITCH_MIDI_NOTE) / HALF_TONES_PER_OCTAVE);
+	p_viz->sample_rate = sample_rate;
+	for (uint32_t note = 0; note < VIZ_NUM_NOTES; note++) {
+		double align_freq = BASE_PITCH_FREQUENCY_HZ * pow(2, ((double) note - BASE_PITCH_MIDI_NOTE) / HALF_TONES_PER_OCTAVE);
+		double window_size = ceil(2 * sample_rate / align_freq);
+		p_viz->window_size[note] = window_size < max_window_size ? (uint32_t) window_size : max_window_size;
+	}
 
-	if (m_viz.sample_index >= VIZ_SAMPLE_COUNT ||
-		m_viz.sample_index >= 2 * AUDIO_SAMPLE_RATE / align_freq) {
-		if (!m_viz.transfer_pending) {
-			m_viz.transfer_pending = true;
-			m_viz.transfer_buffer_size = m_viz.sample_index;
-			memcpy(m_viz.transfer_buffer, m_viz.samples, m_viz.transfer_buffer_size * sizeof(int32_t));
-		}
-		m_viz.sample_index = 0;
+	for (uint32_t i = 0; i < VIZ_NUM_BUFFERS; i++) {
+		p_viz->buffer_size[i] = 0;
 	}
+	p_viz->write_buffer = 0;
+	p_viz->p_write = p_viz->buffers[p_viz->write_buffer];
+	p_viz->sample_index = 0;
+	p_viz->read_buffer = 1;
+	atomic_init(&p_viz->shared_buffer, 2);
 }
 
-ret_code_t visualization_consume_transfer(uint8_t **op_buffer, uint32_t *p_buffer_size) {
-	if (!m_viz.transfer_pending) {
+/**
+ * @brief Take the latest completed window on the reader thread. The buffer stays valid and unchanged until the
+ * next call.
+ *
+ * @param p_viz visualization
+ * @param pp_buffer samples
+ * @param p_buffer_size size in bytes
+ * @return RET_CODE_OK if a new window was available, RET_CODE_ERROR otherwise
+ */
+ret_code_t visualization_consume_transfer(visualization_t *p_viz, uint8_t **pp_buffer, uint32_t *p_buffer_size) {
+	if (!(atomic_load_explicit(&p_viz->shared_buffer, memory_order_relaxed) & VIZ_BUFFER_FRESH)) {
 		return RET_CODE_ERROR;
 	}
 
-	*p_buffer_size = m_viz.transfer_buffer_size * sizeof(int32_t);
-	*op_buffer = (uint8_t *)m_viz.transfer_buffer;
-	m_viz.transfer_pending = false;
+	uint32_t shared = atomic_exchange_explicit(&p_viz->shared_buffer, p_viz->read_buffer, memory_order_acq_rel);
+	p_viz->read_buffer = shared & ~VIZ_BUFFER_FRESH;
+
+	*p_buffer_size = p_viz->buffer_size[p_viz->read_buffer] * sizeof(int32_t);
+	*pp_buffer = (uint8_t *) p_viz->buffers[p_viz->read_buffer];
 
 	return RET_CODE_OK;
 }
+
+static int16_t visualization_to_int16(int32_t sample) {
+	int32_t value = sample >> VIZ_FRAME_SAMPLE_SHIFT;
+	return (int16_t) (value > INT16_MAX ? INT16_MAX : value < INT16_MIN ? INT16_MIN : value);
+}
+
+/**
+ * @brief Build a client frame from a window. Windows longer than the canvas are decimated to a min/max pair per
+ * column, so peaks stay visible, shorter windows are sent one value per sample.
+ *
+ * @param p_samples window
+ * @param num_samples window length
+ * @param num_columns canvas width in pixels, 1..VIZ_FRAME_MAX_COLUMNS
+ * @param sequence window sequence number
+ * @param p_frame output, at least VIZ_FRAME_MAX_SIZE bytes
+ * @return frame size in bytes
+ */
+uint32_t visualization_build_frame(const int32_t *p_samples, uint32_t num_samples, uint32_t num_columns,
+								   uint32_t sequence, uint8_t *p_frame) {
+	visualization_frame_header_t header = {.sequence = sequence, .num_values = 0, .flags = 0};
+	int16_t *p_values = (int16_t *) (p_frame + sizeof(visualization_frame_header_t));
+
+	num_columns = num_columns < 1 ? 1 : num_columns > VIZ_FRAME_MAX_COLUMNS ? VIZ_FRAME_MAX_COLUMNS : num_columns;
+
+	if (num_samples <= 2 * num_columns) {
+		for (uint32_t i = 0; i < num_samples; i++) {
+			p_values[i] = visualization_to_int16(p_samples[i]);
+		}
+		header.num_values = (uint16_t) num_samples;
+	} else {
+		for (uint32_t column = 0; column < num_columns; column++) {
+			uint32_t start = (uint32_t) ((uint64_t) column * num_samples / num_columns);
+			uint32_t end = (uint32_t) ((uint64_t) (column + 1) * num_samples / num_columns);
+			int32_t min = p_samples[start];
+			int32_t max = p_samples[start];
+			for (uint32_t i = start + 1; i < end; i++) {
+				min = p_samples[i] < min ? p_samples[i] : min;
+				max = p_samples[i] > max ? p_samples[i] : max;
+			}
+			p_values[2 * column] = visualization_to_int16(min);
+			p_values[2 * column + 1] = visualization_to_int16(max);
+		}
+		header.num_values = (uint16_t) (2 * num_columns);
+		header.flags = VIZ_FRAME_FLAG_MIN_MAX;
+	}
+
+	memcpy(p_frame, &header, sizeof(header));
+	return (uint32_t) (sizeof(header) + header.num_values * sizeof(int16_t));
+}
@@ -6,10 +6,77 @@
 #define FM_SYNTHESIZER_VISUALIZATION_H
 
 #include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
 #include "common.h"
+#include "config.h"
 
-void visualization_add_sample(int32_t sample, uint32_t align_note);
+#define VIZ_SAMPLES_PER_SECOND             60
+#define VIZ_SAMPLE_COUNT                   (AUDIO_MAX_SAMPLE_RATE / VIZ_SAMPLES_PER_SECOND)
+#define VIZ_NUM_NOTES                      128
+#define VIZ_NUM_BUFFERS                    3
+// Set in the shared buffer index while it holds a window the reader has not taken yet
+#define VIZ_BUFFER_FRESH                   0x4
 
-ret_code_t visualization_consume_transfer(uint8_t **pp_buffer, uint32_t *p_buffer_size);
+// Frames sent to clients hold int16 values, either one per sample or a min/max pair per canvas column
+#define VIZ_FRAME_MAX_COLUMNS              2048
+#define VIZ_FRAME_FLAG_MIN_MAX             0x1
+#define VIZ_FRAME_SAMPLE_SHIFT             15
+#define VIZ_FRAME_MAX_SIZE                 (sizeof(visualization_frame_header_t) + 2 * VIZ_FRAME_MAX_COLUMNS * sizeof(int16_t))
+
+// Little endian on the wire, followed by num_values int16 values
+typedef struct __attribute__((packed)) {
+	uint32_t sequence;
+	uint16_t num_values;
+	uint16_t flags;
+} visualization_frame_header_t;
+
+// Triple buffer between the audio thread (writer) and the web server (reader). Each side owns one buffer, the third
+// is exchanged through shared_buffer, so neither side ever waits and the reader never sees a window being written.
+typedef struct {
+	uint32_t sample_rate;
+	// Samples per window for each alignment note, two periods of the note capped to the frame rate window
+	uint32_t window_size[VIZ_NUM_NOTES];
+
+	int32_t buffers[VIZ_NUM_BUFFERS][VIZ_SAMPLE_COUNT];
+	uint32_t buffer_size[VIZ_NUM_BUFFERS];
+
+	// Audio thread
+	int32_t *p_write;
+	uint32_t write_buffer;
+	uint32_t sample_index;
+
+	// Web server thread
+	uint32_t read_buffer;
+
+	atomic_uint shared_buffer;
+} visualization_t;
+
+void visualization_init(visualization_t *p_viz, uint32_t sample_rate);
+
+/**
+ * @brief Add an output sample on the audio thread. Completed windows are published without copying.
+ *
+ * @param p_viz visualization
+ * @param sample output sample
+ * @param align_note midi note 0..127 the window length is aligned to
+ */
+static inline void visualization_add_sample(visualization_t *p_viz, int32_t sample, uint32_t align_note) {
+	p_viz->p_write[p_viz->sample_index++] = sample;
+
+	if (p_viz->sample_index >= p_viz->window_size[align_note]) {
+		p_viz->buffer_size[p_viz->write_buffer] = p_viz->sample_index;
+		uint32_t shared = atomic_exchange_explicit(&p_viz->shared_buffer, p_viz->write_buffer | VIZ_BUFFER_FRESH,
+												   memory_order_acq_rel);
+		p_viz->write_buffer = shared & ~VIZ_BUFFER_FRESH;
+		p_viz->p_write = p_viz->buffers[p_viz->write_buffer];
+		p_viz->sample_index = 0;
+	}
+}
+
+ret_code_t visualization_consume_transfer(visualization_t *p_viz, uint8_t **pp_buffer, uint32_t *p_buffer_size);
+
+uint32_t visualization_build_frame(const int32_t *p_samples, uint32_t num_samples, uint32_t num_columns,
+								   uint32_t sequence, uint8_t *p_frame);
 
 #endif //FM_SYNTHESIZER_VISUALIZATION_H
@@ -10,10 +10,12 @@
 #include "http_status.h"
 #include "patch_file.h"
 #include "synthesizer.h"
-#include "voice.h"
 
 HTTP_SERVER(server);
 
+// Engine controlled by the routes, set by web_server_start()
+static synth_data_t *m_synth_data;
+
 HTTP_ROUTE_METHOD("/api/get_roms", get_roms, HTTP_METHOD_GET) {
 	json_object_t json_object = {0};
 	const char **rom_names = (const char **) patch_file_get_rom_names();
@@ -30,7 +32,7 @@ HTTP_ROUTE_METHOD("/api/get_roms", get_roms, HTTP_METHOD_GET) {
 	}
 
 	json_value_t is_loaded_value = {0};
-	bool is_loaded = patch_file_is_loaded();
+	bool is_loaded = patch_file_is_loaded(&m_synth_data->patch_file);
 	is_loaded_value.boolean = false;
 	if (json_object_add_value(&json_object, "is_loaded", is_loaded_value, JSON_VALUE_TYPE_BOOLEAN) != RET_CODE_OK) {
 		response.status(HTTP_STATUS_CODE_INTERNAL_SERVER_ERROR);
@@ -38,7 +40,7 @@ HTTP_ROUTE_METHOD("/api/get_roms", get_roms, HTTP_METHOD_GET) {
 	}
 
 	json_value_t current_rom_value = {0};
-	const char *current_rom = is_loaded ? rom_names[patch_file_get_current_rom()] : "";
+	const char *current_rom = is_loaded ? rom_names[patch_file_get_current_rom(&m_synth_data->patch_file)] : "";
 	current_rom_value.string = malloc(strlen(current_rom) + 1);
 	strcpy(current_rom_value.string, current_rom);
 
@@ -72,7 +74,7 @@ HTTP_ROUTE_METHOD("api/select_rom", select_rom, HTTP_METHOD_POST) {
 		return;
 	}
 
-	if (patch_file_load_rom_by_name(p_patch_file->value.string) != RET_CODE_OK) {
+	if (patch_file_load_rom_by_name(&m_synth_data->patch_file, p_patch_file->value.string) != RET_CODE_OK) {
 		response.text("Invalid ROM");
 		response.status(HTTP_STATUS_CODE_BAD_REQUEST);
 		json_object_free(&json_object);
@@ -83,14 +85,14 @@ HTTP_ROUTE_METHOD("api/select_rom", select_rom, HTTP_METHOD_POST) {
 }
 
 HTTP_ROUTE_METHOD("api/get_patches", get_patches, HTTP_METHOD_GET) {
-	if (!patch_file_is_loaded()) {
+	if (!patch_file_is_loaded(&m_synth_data->patch_file)) {
 		response.text("No ROM loaded");
 		response.status(HTTP_STATUS_CODE_BAD_REQUEST);
 		return;
 	}
 
 	json_object_t json_object = {0};
-	voice_params_t *p_voice_params = (voice_params_t *) patch_file_get_voice_params();
+	voice_params_t *p_voice_params = (voice_params_t *) patch_file_get_voice_params(&m_synth_data->patch_file);
 
 	char patch_names[PATCH_FILE_NUM_VOICES][sizeof(p_voice_params[0].name) + 1];
 	for (uint8_t i = 0; i < PATCH_FILE_NUM_VOICES; i++) {
@@ -117,7 +119,7 @@ HTTP_ROUTE_METHOD("api/get_patches", get_patches, HTTP_METHOD_GET) {
 	}
 
 	json_value_t current_patch_value = {0};
-	char *current_patch = patch_names[patch_file_get_current_patch_number()];
+	char *current_patch = patch_names[patch_file_get_current_patch_number(&m_synth_data->patch_file)];
 	current_patch_value.string = malloc(strlen(current_patch) + 1);
 	strcpy(current_patch_value.string, current_patch);
 
@@ -151,18 +153,32 @@ HTTP_ROUTE_METHOD("api/select_patch", select_patch, HTTP_METHOD_POST) {
 		return;
 	}
 
-	if (patch_file_load_patch_by_name(p_patch->value.string, &synth_data.voice_params) != RET_CODE_OK) {
+	voice_params_t voice_params;
+	if (patch_file_load_patch_by_name(&m_synth_data->patch_file, p_patch->value.string, &voice_params) != RET_CODE_OK) {
 		response.text("Invalid patch");
 		response.status(HTTP_STATUS_CODE_BAD_REQUEST);
 		json_object_free(&json_object);
 		return;
 	}
 
+	// The audio thread switches to the new render plan between two buffers
+	if (synthesizer_set_patch(m_synth_data, &voice_params) != RET_CODE_OK) {
+		response.text("Failed to set patch");
+		response.status(HTTP_STATUS_CODE_INTERNAL_SERVER_ERROR);
+		json_object_free(&json_object);
+		return;
+	}
+
 	json_object_free(&json_object);
 }
 
 HTTP_ROUTE_METHOD("api/get_params", get_params, HTTP_METHOD_GET) {
-	voice_params_t *p_params = &synth_data.voice_params;
+	const voice_params_t *p_params = synthesizer_get_patch(m_synth_data);
+	if (p_params == NULL) {
+		response.text("No patch loaded");
+		response.status(HTTP_STATUS_CODE_BAD_REQUEST);
+		return;
+	}
 
 	uint32_t string_length = 10*1024;
 	char *json_string = malloc(string_length);
@@ -206,28 +222,33 @@ HTTP_ROUTE_METHOD("api/get_params", get_params, HTTP_METHOD_GET) {
 WEBSOCKET_ROUTE("api/midi", midi) {
 	switch (websocket.event) {
 		case WEBSOCKET_EVENT_DATA:
-			printf("MIDI message: %02X %02X %02X\n", websocket.data[0], websocket.data[1], websocket.data[2]);
 			if (websocket.data_length != 3) {
 				log_error("Invalid MIDI message length: %u", websocket.data_length);
 				return;
 			}
-			uint8_t status = websocket.data[0] & 0xF0;
-			uint8_t channel = websocket.data[0] & 0x0F;
-			uint8_t data1 = websocket.data[1];
-			uint8_t data2 = websocket.data[2];
-
-			// Reject not note on/off messages
-			if (status != 0x80 && status != 0x90) {
-				log_error("Unhandled MIDI message: %02X", status);
+
+			// Handled on the audio thread, unhandled messages are counted as dropped
+			synthesizer_queue_midi_event(m_synth_data, websocket.data[0], websocket.data[1], websocket.data[2]);
+			break;
+		default:
+			break;
+	}
+}
+
+WEBSOCKET_ROUTE("api/params", params) {
+	switch (websocket.event) {
+		case WEBSOCKET_EVENT_DATA:
+			if (websocket.data_length == 0 || websocket.data_length % PARAM_EDIT_MESSAGE_SIZE != 0) {
+				log_error("Invalid parameter edit length: %u", websocket.data_length);
 				return;
 			}
 
-			if (status == 0x80) {
-				// Note off
-				voice_release_key(data1, data2);
-			} else {
-				// Note on
-				voice_assign_key(data1, data2);
+			// Applied on the audio thread, rejected and overflowed edits are counted
+			for (uint32_t offset = 0; offset < websocket.data_length; offset += PARAM_EDIT_MESSAGE_SIZE) {
+				const uint8_t *p_edit = (const uint8_t *) websocket.data + offset;
+				if (synthesizer_queue_param_edit(m_synth_data, p_edit[0], p_edit[1], p_edit[2]) != RET_CODE_OK) {
+					log_error("Failed to queue parameter edit: operator %u, parameter %u, value %u", p_edit[0], p_edit[1], p_edit[2]);
+				}
 			}
 			break;
 		default:
@@ -235,30 +256,132 @@ WEBSOCKET_ROUTE("api/midi", midi) {
 	}
 }
 
-HTTP_ROUTE_METHOD("/api/viz_stream", visualization_stream, HTTP_METHOD_GET) {
-	uint8_t *p_transfer_buffer = NULL;
-	uint32_t transfer_buffer_size = 0;
-	if (visualization_consume_transfer(&p_transfer_buffer, &transfer_buffer_size) == RET_CODE_OK) {
-		char chunk_size[16];
-		sprintf(chunk_size, "%x\r\n", transfer_buffer_size);
-
-		response.append((uint8_t *) chunk_size, strlen(chunk_size));
-		response.append((uint8_t *) p_transfer_buffer, transfer_buffer_size);
-		response.append((uint8_t *) "\r\n", 2);
-
-		http_headers_set_value_string(response.p_headers, response.p_num_headers, "Transfer-Encoding", "chunked");
-		http_headers_set_value_string(response.p_headers, response.p_num_headers, "Content-Type", "application/octet-stream");
-		http_headers_unset(response.p_headers, response.p_num_headers, "Content-Length");
-		response.send();
+// Latest visualization window, numbered so a client is only sent windows it has not drawn yet. The samples stay
+// valid until the next visualization_consume_transfer().
+static struct {
+	const int32_t *p_samples;
+	uint32_t num_samples;
+	uint32_t sequence;
+} m_viz_window;
+
+static uint8_t m_viz_frame[VIZ_FRAME_MAX_SIZE];
+
+// Client request: uint16 canvas width, uint32 sequence of the last frame it received, little endian
+#define VIZ_REQUEST_SIZE			6
+
+WEBSOCKET_ROUTE("api/viz", visualization_socket) {
+	switch (websocket.event) {
+		case WEBSOCKET_EVENT_DATA: {
+			if (websocket.data_length != VIZ_REQUEST_SIZE) {
+				log_error("Invalid visualization request length: %u", websocket.data_length);
+				return;
+			}
+			uint16_t num_columns = (uint16_t) (websocket.data[0] | websocket.data[1] << 8);
+			uint32_t last_sequence = (uint32_t) websocket.data[2] | (uint32_t) websocket.data[3] << 8 |
+									 (uint32_t) websocket.data[4] << 16 | (uint32_t) websocket.data[5] << 24;
+
+			// All clients share the window taken from the audio thread
+			uint8_t *p_transfer_buffer = NULL;
+			uint32_t transfer_buffer_size = 0;
+			if (m_synth_data->p_visualization != NULL &&
+				visualization_consume_transfer(m_synth_data->p_visualization, &p_transfer_buffer, &transfer_buffer_size) == RET_CODE_OK) {
+				m_viz_window.p_samples = (const int32_t *) p_transfer_buffer;
+				m_viz_window.num_samples = transfer_buffer_size / sizeof(int32_t);
+				m_viz_window.sequence++;
+			}
+
+			if (m_viz_window.p_samples == NULL || m_viz_window.sequence == last_sequence) {
+				return;
+			}
+
+			uint32_t frame_size = visualization_build_frame(m_viz_window.p_samples, m_viz_window.num_samples, num_columns,
+															m_viz_window.sequence, m_viz_frame);
+			websocket.send(m_viz_frame, frame_size);
+			break;
+		}
+		default:
+			break;
 	}
 }
 
 HTTP_ROUTE_METHOD("/api/init", init, HTTP_METHOD_POST) {
-	voice_init();
+	// Voices are owned by the audio thread, reset them through the event queue
+	if (synthesizer_queue_midi_event(m_synth_data, MIDI_STATUS_CONTROL_CHANGE, MIDI_CONTROL_ALL_SOUND_OFF, 0) != RET_CODE_OK) {
+		response.text("Failed to reset voices");
+		response.status(HTTP_STATUS_CODE_INTERNAL_SERVER_ERROR);
+		return;
+	}
+}
+
+HTTP_ROUTE_METHOD("api/stats", stats, HTTP_METHOD_GET) {
+	render_stats_snapshot_t render_stats;
+	midi_queue_counters_t midi_counters;
+	param_queue_counters_t param_counters;
+	voice_governor_counters_t governor_counters;
+	synthesizer_get_render_stats(m_synth_data, &render_stats);
+	synthesizer_get_midi_counters(m_synth_data, &midi_counters);
+	synthesizer_get_param_counters(m_synth_data, &param_counters);
+	synthesizer_get_governor_counters(m_synth_data, &governor_counters);
+
+	uint32_t string_length = 16 * 1024;
+	char *json_string = malloc(string_length);
+	uint32_t index = 0;
+	index += snprintf(json_string + index, string_length - index,
+					  "{\"sample_rate\":%u,\"frames_per_buffer\":%u,\"num_voices\":%u,"
+					  "\"callbacks\":%llu,\"frames\":%llu,\"load\":{\"avg\":%.4f,\"max\":%.4f,\"last\":%.4f},"
+					  "\"deadline_misses\":%u,\"underflows\":%u,\"overflows\":%u,"
+					  "\"voices\":{\"current\":%u,\"max\":%u,\"avg\":%.2f},"
+					  "\"midi\":{\"dropped\":%u,\"overflowed\":%u,\"pending\":%u},"
+					  "\"params\":{\"applied\":%u,\"rejected\":%u,\"overflowed\":%u,\"pending\":%u},"
+					  "\"governor\":{\"enabled\":%s,\"voice_limit\":%u,\"smoothed_load\":%.4f,\"reductions\":%u,"
+					  "\"restores\":%u,\"voices_freed\":%u,\"events_dropped\":%u},"
+					  "\"load_histogram\":{\"bucket_percent\":%u,\"counts\":[",
+					  m_synth_data->sample_rate, AUDIO_FRAMES_PER_BUFFER, NUM_VOICES,
+					  (unsigned long long) render_stats.num_callbacks, (unsigned long long) render_stats.num_frames,
+					  render_stats.avg_load, render_stats.max_load, render_stats.last_load,
+					  render_stats.num_deadline_misses, render_stats.num_underflows, render_stats.num_overflows,
+					  render_stats.num_voices, render_stats.max_voices, render_stats.avg_voices,
+					  midi_counters.num_dropped, midi_counters.num_overflowed, midi_counters.num_pending,
+					  param_counters.num_applied, param_counters.num_rejected, param_counters.num_overflowed,
+					  param_counters.num_pending,
+					  governor_counters.enabled ? "true" : "false", governor_counters.voice_limit, governor_counters.smoothed_load,
+					  governor_counters.num_reductions, governor_counters.num_restores, governor_counters.num_voices_freed,
+					  governor_counters.num_events_dropped,
+					  RENDER_STATS_LOAD_BUCKET_PERCENT);
+	for (uint32_t i = 0; i < RENDER_STATS_NUM_LOAD_BUCKETS; i++) {
+		index += snprintf(json_string + index, string_length - index, i > 0 ? ",%llu" : "%llu",
+						  (unsigned long long) render_stats.load_histogram[i]);
+	}
+	index += snprintf(json_string + index, string_length - index, "]}");
+
+	// Per-stage render time by algorithm, only collected when built with SYNTH_PROFILE_STAGES
+	render_profile_snapshot_t profile;
+	synthesizer_get_render_profile(m_synth_data, &profile);
+	index += snprintf(json_string + index, string_length - index, ",\"profile\":{\"enabled\":%s,\"unit\":\"%s\",\"algorithms\":[",
+					  SYNTH_PROFILE_STAGES ? "true" : "false", RENDER_PROFILE_UNIT);
+	bool first = true;
+	for (uint32_t algorithm = 0; algorithm < RENDER_PROFILE_NUM_ALGORITHMS; algorithm++) {
+		if (profile.num_frames[algorithm] == 0) {
+			continue;
+		}
+		index += snprintf(json_string + index, string_length - index, "%s{\"algorithm\":%u,\"frames\":%llu",
+						  first ? "" : ",", algorithm + 1, (unsigned long long) profile.num_frames[algorithm]);
+		for (uint32_t stage = 0; stage < RENDER_STAGE_COUNT; stage++) {
+			index += snprintf(json_string + index, string_length - index, ",\"%s\":%llu", render_stage_names[stage],
+							  (unsigned long long) profile.ticks[algorithm][stage]);
+		}
+		index += snprintf(json_string + index, string_length - index, "}");
+		first = false;
+	}
+	index += snprintf(json_string + index, string_length - index, "]}}");
+
+	response.json(json_string);
+
+	free(json_string);
 }
 
-ret_code_t web_server_start(void) {
-	visualization_stream.streaming = true;
+ret_code_t web_server_start(synth_data_t *data) {
+	m_synth_data = data;
 	http_route_t routes[] = {
 			get_roms,
 			select_rom,
@@ -266,12 +389,13 @@ ret_code_t web_server_start(void) {
 			select_patch,
 			get_params,
 			midi,
-			visualization_stream,
-			init
+			params,
+			visualization_socket,
+			init,
+			stats
 	};
 	server.routes(routes, sizeof(routes) / sizeof(http_route_t));
 	server.serve_static("static");
-	server.hook(voice_update);
 
 	// Blocking call
 	server.run();
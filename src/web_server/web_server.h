@@ -6,7 +6,8 @@
 #define FM_SYNTHESIZER_WEB_SERVER_H
 
 #include "common.h"
+#include "synthesizer.h"
 
-ret_code_t web_server_start(void);
+ret_code_t web_server_start(synth_data_t *data);
 
 #endif //FM_SYNTHESIZER_WEB_SERVER_H
@@ -0,0 +1,200 @@
+//
+// Created by Tim Holzhey on 17.10.26
+//
+
+#define _GNU_SOURCE
+#include <sched.h>
+#include <unistd.h>
+#include "worker_pool.h"
+
+#define JOB_GENERATION(job)				((uint32_t) ((job) >> 32))
+#define JOB_NUM_TASKS(job)				((uint32_t) (((job) >> 16) & 0xFFFF))
+#define JOB_NEXT_TASK(job)				((uint32_t) ((job) & 0xFFFF))
+
+static ret_code_t worker_pool_semaphore_init(worker_pool_semaphore_t *p_semaphore) {
+#ifdef __APPLE__
+	*p_semaphore = dispatch_semaphore_create(0);
+	return *p_semaphore != NULL ? RET_CODE_OK : RET_CODE_ERROR;
+#else
+	return sem_init(p_semaphore, 0, 0) == 0 ? RET_CODE_OK : RET_CODE_ERROR;
+#endif
+}
+
+static void worker_pool_semaphore_destroy(worker_pool_semaphore_t *p_semaphore) {
+#ifdef __APPLE__
+	dispatch_release(*p_semaphore);
+#else
+	sem_destroy(p_semaphore);
+#endif
+}
+
+static void worker_pool_semaphore_post(worker_pool_semaphore_t *p_semaphore) {
+#ifdef __APPLE__
+	dispatch_semaphore_signal(*p_semaphore);
+#else
+	sem_post(p_semaphore);
+#endif
+}
+
+static void worker_pool_semaphore_wait(worker_pool_semaphore_t *p_semaphore) {
+#ifdef __APPLE__
+	dispatch_semaphore_wait(*p_semaphore, DISPATCH_TIME_FOREVER);
+#else
+	while (sem_wait(p_semaphore) != 0) {
+	}
+#endif
+}
+
+/**
+ * @brief Wake every parked worker. Lock-free, safe to call from the audio thread.
+ */
+static void worker_pool_wake(worker_pool_t *p_pool) {
+	for (uint32_t i = 0; i < p_pool->num_threads; i++) {
+		if (atomic_exchange(&p_pool->sleeping[i], false)) {
+			worker_pool_semaphore_post(&p_pool->wake_semaphores[i]);
+		}
+	}
+}
+
+/**
+ * @brief Park a worker until the job generation changes or the pool stops.
+ */
+static void worker_pool_park(worker_pool_t *p_pool, uint32_t thread_idx, uint32_t generation) {
+	// Announce the sleep before the last check, a job published after the check sees the flag and posts
+	atomic_store(&p_pool->sleeping[thread_idx], true);
+	if (JOB_GENERATION(atomic_load(&p_pool->job)) == generation && atomic_load(&p_pool->running)) {
+		worker_pool_semaphore_wait(&p_pool->wake_semaphores[thread_idx]);
+		return;
+	}
+
+	// Woken before sleeping: withdraw the flag, or consume the post the caller already made
+	if (!atomic_exchange(&p_pool->sleeping[thread_idx], false)) {
+		worker_pool_semaphore_wait(&p_pool->wake_semaphores[thread_idx]);
+	}
+}
+
+/**
+ * @brief Claim and run tasks of a job generation until none are left.
+ */
+static void worker_pool_run_tasks(worker_pool_t *p_pool, uint32_t generation) {
+	uint_fast64_t job = atomic_load(&p_pool->job);
+
+	while (JOB_GENERATION(job) == generation && JOB_NEXT_TASK(job) < JOB_NUM_TASKS(job)) {
+		if (!atomic_compare_exchange_weak(&p_pool->job, &job, job + 1)) {
+			continue;
+		}
+
+		p_pool->task(p_pool->p_context, JOB_NEXT_TASK(job));
+		atomic_fetch_add_explicit(&p_pool->num_done, 1, memory_order_release);
+		job = atomic_load(&p_pool->job);
+	}
+}
+
+static void *worker_pool_thread(void *p_arg) {
+	worker_pool_t *p_pool = p_arg;
+	uint32_t thread_idx = atomic_fetch_add(&p_pool->num_started, 1);
+	uint32_t generation = JOB_GENERATION(atomic_load(&p_pool->job));
+
+	while (true) {
+		// Spin for a short while, jobs of consecutive audio blocks arrive in quick succession
+		uint32_t spin = 0;
+		while (JOB_GENERATION(atomic_load_explicit(&p_pool->job, memory_order_acquire)) == generation &&
+			   atomic_load_explicit(&p_pool->running, memory_order_relaxed) && spin++ < WORKER_POOL_SPIN_ITERATIONS) {
+		}
+
+		// Sleep until the next job
+		while (JOB_GENERATION(atomic_load(&p_pool->job)) == generation && atomic_load(&p_pool->running)) {
+			worker_pool_park(p_pool, thread_idx, generation);
+		}
+
+		if (!atomic_load(&p_pool->running)) {
+			break;
+		}
+
+		generation = JOB_GENERATION(atomic_load(&p_pool->job));
+		worker_pool_run_tasks(p_pool, generation);
+	}
+
+	return NULL;
+}
+
+ret_code_t worker_pool_init(worker_pool_t *p_pool, uint32_t num_threads) {
+	if (num_threads == 0 || num_threads > WORKER_POOL_MAX_THREADS) {
+		log_error("Invalid number of worker threads: %u", num_threads);
+		return RET_CODE_ERROR;
+	}
+
+	p_pool->num_threads = 0;
+	p_pool->task = NULL;
+	p_pool->p_context = NULL;
+	atomic_init(&p_pool->job, 0);
+	atomic_init(&p_pool->num_done, 0);
+	atomic_init(&p_pool->num_started, 0);
+	atomic_init(&p_pool->running, true);
+
+	long num_cores = sysconf(_SC_NPROCESSORS_ONLN);
+	for (uint32_t i = 0; i < num_threads; i++) {
+		atomic_init(&p_pool->sleeping[i], false);
+		if (worker_pool_semaphore_init(&p_pool->wake_semaphores[i]) != RET_CODE_OK) {
+			log_error("Failed to create the semaphore of worker thread %u", i);
+			worker_pool_deinit(p_pool);
+			return RET_CODE_ERROR;
+		}
+
+		if (pthread_create(&p_pool->threads[i], NULL, worker_pool_thread, p_pool) != 0) {
+			log_error("Failed to start worker thread %u", i);
+			worker_pool_semaphore_destroy(&p_pool->wake_semaphores[i]);
+			worker_pool_deinit(p_pool);
+			return RET_CODE_ERROR;
+		}
+		p_pool->num_threads++;
+
+#ifdef __linux__
+		// Core 0 is left to the calling (audio) thread
+		if (num_cores > 1) {
+			cpu_set_t cpu_set;
+			CPU_ZERO(&cpu_set);
+			CPU_SET((i + 1) % num_cores, &cpu_set);
+			if (pthread_setaffinity_np(p_pool->threads[i], sizeof(cpu_set), &cpu_set) != 0) {
+				log_warning("Failed to pin worker thread %u", i);
+			}
+		}
+#else
+		(void) num_cores;
+#endif
+	}
+
+	return RET_CODE_OK;
+}
+
+void worker_pool_deinit(worker_pool_t *p_pool) {
+	atomic_store(&p_pool->running, false);
+	worker_pool_wake(p_pool);
+
+	for (uint32_t i = 0; i < p_pool->num_threads; i++) {
+		pthread_join(p_pool->threads[i], NULL);
+		worker_pool_semaphore_destroy(&p_pool->wake_semaphores[i]);
+	}
+	p_pool->num_threads = 0;
+}
+
+void worker_pool_run(worker_pool_t *p_pool, worker_pool_task_t task, void *p_context, uint32_t num_tasks) {
+	if (num_tasks == 0) {
+		return;
+	}
+
+	// The previous job has finished, so no thread reads task and context while they are replaced
+	p_pool->task = task;
+	p_pool->p_context = p_context;
+	atomic_store_explicit(&p_pool->num_done, 0, memory_order_relaxed);
+
+	uint32_t generation = JOB_GENERATION(atomic_load(&p_pool->job)) + 1;
+	atomic_store(&p_pool->job, ((uint_fast64_t) generation << 32) | ((uint_fast64_t) num_tasks << 16));
+
+	worker_pool_wake(p_pool);
+
+	worker_pool_run_tasks(p_pool, generation);
+
+	while (atomic_load_explicit(&p_pool->num_done, memory_order_acquire) < num_tasks) {
+	}
+}
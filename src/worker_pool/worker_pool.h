@@ -0,0 +1,85 @@
+//
+// Created by Tim Holzhey on 17.10.26
+//
+
+#ifndef FM_SYNTHESIZER_WORKER_POOL_H
+#define FM_SYNTHESIZER_WORKER_POOL_H
+
+#include "common.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#ifdef __APPLE__
+#include <dispatch/dispatch.h>
+#else
+#include <semaphore.h>
+#endif
+
+#define WORKER_POOL_MAX_THREADS			64
+#define WORKER_POOL_MAX_TASKS			0xFFFF
+// Spin only long enough to catch the next render block of the same callback (tens of microseconds), a worker
+// parks on its semaphore between callbacks instead of burning its core for a whole buffer period
+#define WORKER_POOL_SPIN_ITERATIONS		20000
+
+#ifdef __APPLE__
+typedef dispatch_semaphore_t worker_pool_semaphore_t;
+#else
+typedef sem_t worker_pool_semaphore_t;
+#endif
+
+/**
+ * Task of a job, called once for every task index 0..num_tasks - 1 from any pool thread or the caller.
+ */
+typedef void (*worker_pool_task_t)(void *p_context, uint32_t task_idx);
+
+/**
+ * Persistent worker threads, each pinned to its own core. A job is published in a single atomic word
+ * (generation << 32 | num_tasks << 16 | next task index), threads claim task indices from it with
+ * compare-and-swap so a thread that is late for a job can never claim a task of the next one.
+ * An idle worker parks on its own semaphore after announcing it in its sleeping flag. Waking it takes the
+ * caller one flag exchange and a semaphore post, which only enters the kernel if the worker really sleeps,
+ * so the audio thread never takes a lock.
+ */
+typedef struct {
+	pthread_t threads[WORKER_POOL_MAX_THREADS];
+	uint32_t num_threads;
+	worker_pool_semaphore_t wake_semaphores[WORKER_POOL_MAX_THREADS];
+	atomic_bool sleeping[WORKER_POOL_MAX_THREADS];
+	// Started threads take their index from here
+	atomic_uint num_started;
+	atomic_uint_fast64_t job;
+	atomic_uint num_done;
+	atomic_bool running;
+	worker_pool_task_t task;
+	void *p_context;
+} worker_pool_t;
+
+/**
+ * @brief Start the worker threads. The calling thread also runs tasks, so num_threads extra threads are started.
+ *
+ * @param p_pool
+ * @param num_threads 1..WORKER_POOL_MAX_THREADS
+ * @return RET_CODE_OK on success
+ */
+ret_code_t worker_pool_init(worker_pool_t *p_pool, uint32_t num_threads);
+
+/**
+ * @brief Stop and join the worker threads.
+ *
+ * @param p_pool
+ */
+void worker_pool_deinit(worker_pool_t *p_pool);
+
+/**
+ * @brief Run all tasks of a job on the pool and the calling thread, returns when every task has finished.
+ * Tasks run in any order on any thread, callers must make the result independent of the assignment.
+ *
+ * @param p_pool
+ * @param task
+ * @param p_context passed to every task
+ * @param num_tasks 0..WORKER_POOL_MAX_TASKS
+ */
+void worker_pool_run(worker_pool_t *p_pool, worker_pool_task_t task, void *p_context, uint32_t num_tasks);
+
+#endif //FM_SYNTHESIZER_WORKER_POOL_H
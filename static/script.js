@@ -62,60 +62,70 @@ window.onload = function () {
     };
     loadParams();
 
-    // Visualization
-    let samples = new Int32Array(1024).fill(0);
-    fetch(`http://${window.location.host}/api/viz_stream`)
-        .then(async (response) => {
-            const reader = response.body.getReader();
-            for await (const chunk of readChunks(reader)) {
-                if (chunk.buffer.byteLength % 4 !== 0) {
-                    console.log("Invalid chunk size");
-                    continue;
-                }
-                samples = new Int32Array(chunk.buffer);
-            }
-        });
-    
-    setInterval(function () {
-        let max = 0;
-        for (let i = 0; i < samples.length; i++) {
-            const sample = samples[i] / 32768;
-            samples[i] = sample;
-            if (Math.abs(sample) > max) {
-                max = Math.abs(sample);
-            }
+    // Visualization, the server answers a request with the newest frame we have not drawn yet
+    const VIZ_FRAME_FLAG_MIN_MAX = 0x1;
+    let vizSequence = 0;
+    let vizValues = new Int16Array(0);
+    let vizMinMax = false;
+    const ws_viz = new WebSocket(`ws://${window.location.host}/api/viz`);
+    ws_viz.binaryType = "arraybuffer";
+    ws_viz.onmessage = function (event) {
+        if (event.data.byteLength < 8) {
+            console.log("Invalid frame size");
+            return;
         }
+        const header = new DataView(event.data, 0, 8);
+        vizSequence = header.getUint32(0, true);
+        vizMinMax = (header.getUint16(6, true) & VIZ_FRAME_FLAG_MIN_MAX) !== 0;
+        vizValues = new Int16Array(event.data, 8, header.getUint16(4, true));
+    };
+
+    function drawVisualization() {
         const canvas = document.getElementById("viz");
         const ctx = canvas.getContext("2d");
         const width = canvas.width;
         const height = canvas.height;
-        const xStep = width / samples.length;
-        let yStep = height / 2 / max;
-        yStep = Math.min(yStep, 1);
+
+        if (ws_viz.readyState === WebSocket.OPEN) {
+            const request = new DataView(new ArrayBuffer(6));
+            request.setUint16(0, width, true);
+            request.setUint32(2, vizSequence, true);
+            ws_viz.send(request.buffer);
+        }
+
+        let max = 1;
+        for (let i = 0; i < vizValues.length; i++) {
+            max = Math.max(max, Math.abs(vizValues[i]));
+        }
+        const yStep = Math.min(height / 2 / max, 1);
         ctx.strokeStyle = "#ffffff";
         ctx.lineWidth = 2;
         ctx.clearRect(0, 0, width, height);
         ctx.beginPath();
-        for (let i = 0; i < samples.length; i++) {
-            if (i === 0) {
-                ctx.moveTo(0, height / 2 + samples[i] * yStep);
+        if (vizMinMax) {
+            // One min/max pair per column, joined into one trace
+            const numColumns = vizValues.length / 2;
+            for (let i = 0; i < numColumns; i++) {
+                const x = i * width / numColumns;
+                if (i === 0) {
+                    ctx.moveTo(x, height / 2 + vizValues[0] * yStep);
+                }
+                ctx.lineTo(x, height / 2 + vizValues[2 * i] * yStep);
+                ctx.lineTo(x, height / 2 + vizValues[2 * i + 1] * yStep);
+            }
+        } else {
+            const xStep = width / Math.max(vizValues.length, 1);
+            for (let i = 0; i < vizValues.length; i++) {
+                if (i === 0) {
+                    ctx.moveTo(0, height / 2 + vizValues[i] * yStep);
+                }
+                ctx.lineTo(i * xStep, height / 2 + vizValues[i] * yStep);
             }
-            ctx.lineTo(i * xStep, height / 2 + samples[i] * yStep);
         }
         ctx.stroke();
-    }, 1000 / 30);
-
-    function readChunks(reader) {
-        return {
-            async* [Symbol.asyncIterator]() {
-                let readResult = await reader.read();
-                while (!readResult.done) {
-                    yield readResult.value;
-                    readResult = await reader.read();
-                }
-            },
-        };
+        requestAnimationFrame(drawVisualization);
     }
+    requestAnimationFrame(drawVisualization);
 
     // Play MIDI with keyboard
     qwertyNotes = [];
@@ -238,6 +248,79 @@ window.onload = function () {
         });
     });
 
+    // Parameter edits, sent as [operator, parameter id, value] with the ids of param_id_t in param_queue.h
+    const PARAM_IDS = {
+        "env.rates[0]": 0,
+        "env.rates[1]": 1,
+        "env.rates[2]": 2,
+        "env.rates[3]": 3,
+        "env.levels[0]": 4,
+        "env.levels[1]": 5,
+        "env.levels[2]": 6,
+        "env.levels[3]": 7,
+        "kls.break_point": 8,
+        "kls.left_depth": 9,
+        "kls.right_depth": 10,
+        "kls.left_curve": 11,
+        "kls.right_curve": 12,
+        "osc.mode": 13,
+        "osc.frequency_coarse": 14,
+        "osc.frequency_fine": 15,
+        "osc.detune": 16,
+        "keyboard_rate_scaling": 17,
+        "amplitude_modulation_sensitivity": 18,
+        "key_velocity_sensitivity": 19,
+        "output_level": 20
+    };
+    const KNOB_PIXELS_PER_STEP = 4;
+    const ws_params = new WebSocket(`ws://${window.location.host}/api/params`);
+
+    function sendParam(param) {
+        const match = /^operators\[(\d)\]\.(.+)$/.exec(param.getAttribute("data-param"));
+        if (match === null || !(match[2] in PARAM_IDS) || ws_params.readyState !== WebSocket.OPEN) {
+            return;
+        }
+        const value = Number(param.getAttribute("data-value"));
+        ws_params.send(new Uint8Array([Number(match[1]), PARAM_IDS[match[2]], value]));
+    }
+
+    document.querySelectorAll(".param.knob, .param.slider").forEach(param => {
+        param.addEventListener("mousedown", function (event) {
+            event.preventDefault();
+            const min = Number(param.getAttribute("data-min"));
+            const max = Number(param.getAttribute("data-max"));
+            const startValue = Number(param.getAttribute("data-value"));
+            const startY = event.clientY;
+
+            function onMove(moveEvent) {
+                const steps = Math.round((startY - moveEvent.clientY) / KNOB_PIXELS_PER_STEP);
+                const value = Math.min(max, Math.max(min, startValue + steps));
+                if (value !== Number(param.getAttribute("data-value"))) {
+                    param.setAttribute("data-value", value);
+                    updateControlUI();
+                    sendParam(param);
+                }
+            }
+
+            function onUp() {
+                document.removeEventListener("mousemove", onMove);
+                document.removeEventListener("mouseup", onUp);
+            }
+
+            document.addEventListener("mousemove", onMove);
+            document.addEventListener("mouseup", onUp);
+        });
+    });
+
+    document.querySelectorAll(".param.toggle").forEach(toggle => {
+        toggle.addEventListener("click", function (event) {
+            const on = Number(toggle.getAttribute("data-value")) === 1;
+            toggle.setAttribute("data-value", on ? toggle.getAttribute("data-off") : toggle.getAttribute("data-on"));
+            updateControlUI();
+            sendParam(toggle);
+        });
+    });
+
     // Init
     fetch("/api/init", {method: "POST"});
 
@@ -265,7 +348,7 @@ window.onload = function () {
         const toggles = document.querySelectorAll(".param.toggle");
         toggles.forEach(toggle => {
             const value = toggle.getAttribute("data-value");
-            if (value === "true") {
+            if (value === "true" || Number(value) === 1) {
                 toggle.classList.add("active");
             } else {
                 toggle.classList.remove("active");